@@ -1,7 +1,58 @@
 #include "Application.hpp"
+#include "Scene.hpp"
 
 #include <glm/glm.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+    SDL_Rect toRect(const Component::Transform &transform) {
+        return SDL_Rect{static_cast<int>(transform.position.x), static_cast<int>(transform.position.y), static_cast<int>(transform.scale.x), static_cast<int>(transform.scale.y)};
+    }
+
+    SDL_Color toColor(const Component::Color &color) {
+        return SDL_Color{color.r, color.g, color.b, color.a};
+    }
+
+    // Opens the level the simulation is built on, or returns null for the built-in one.
+    const Level::File *openLevel(Level::File &level, const std::string &path) {
+        if (path.empty()) {
+            return nullptr;
+        }
+        if (!level.open(path)) {
+            SDL_Log("Failed to open level %s", path.c_str());
+            std::exit(EXIT_FAILURE);
+        }
+        return &level;
+    }
+
+    SDL_Color toOutlineColor(const SDL_Color &fill) {
+        return toColor(Scene::getOutlineColor(Component::Color{fill.r, fill.g, fill.b, fill.a}));
+    }
+
+    Rasterizer::Rect toRasterRect(const SDL_Rect &rect) {
+        return Rasterizer::Rect{rect.x, rect.y, rect.w, rect.h};
+    }
+
+    Rasterizer::Color toRasterColor(const SDL_Color &color) {
+        return Rasterizer::Color{color.r, color.g, color.b, color.a};
+    }
+
+    ParticleSystem::Config toParticleConfig(const Application::Options &options) {
+        ParticleSystem::Config config;
+        config.capacity = options.maxParticles;
+        return config;
+    }
+
+    // Edge length of a particle in pixels.
+    constexpr int particleSize = 3;
+}// namespace
+
+Application::Application(const Options &options) : mSimulation(options.simulation, openLevel(mLevel, options.levelPath)), mParticles(toParticleConfig(options)), mOptions(options) {}
+
 void Application::run() {
     if (SDL_SetHint(SDL_HINT_JOYSTICK_HIDAPI_PS4_RUMBLE, "1") == SDL_FALSE) {
         SDL_Log("Failed to set hint: %s", SDL_GetError());
@@ -22,51 +73,127 @@ void Application::run() {
         std::exit(EXIT_FAILURE);
     }
 
-    mRenderer = SDL_CreateRenderer(mWindow, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    const Uint32 vsync = mOptions.vsync ? SDL_RENDERER_PRESENTVSYNC : 0;
+    mRenderer = SDL_CreateRenderer(mWindow, -1, SDL_RENDERER_ACCELERATED | vsync);
     if (!mRenderer) {
         SDL_Log("Failed to create renderer: %s", SDL_GetError());
         std::exit(EXIT_FAILURE);
     }
 
-    respawnGoal();
-    respawnWalls();
-    respawnBricks();
-    respawnBalls();
-    respawnPaddles();
+    mSimulation.setProfiler(&mProfiler);
+    if (const unsigned cores = std::thread::hardware_concurrency(); cores > 2 && mOptions.particlesPerBrick > 0) {
+        mParticleThreads = std::make_unique<ThreadPool>(cores - 2);
+    }
+    if (!mOptions.tracePath.empty()) {
+        mProfiler.beginTrace();
+    }
+
+    mSimulation.getDispatcher().sink<Event::BrickDestroyed>().connect<&Application::onBrickDestroyed>(*this);
+    mSimulation.getDispatcher().sink<Event::BricksRespawned>().connect<&Application::onBricksRespawned>(*this);
+    mSimulation.reset();
+    if (mOptions.memoryReport) {
+        logMemoryReport();
+    }
+    if (!mOptions.recordPath.empty()) {
+        mRecorder.emplace(mOptions.simulation, mOptions.tickRate, Replay::UpdateEveryStep);
+        if (mLevel.isOpen()) {
+            mRecorder->setLevel(mLevel);
+        }
+    }
 
-    const float fixedDeltaTime = 1.0f / 240.0f;
-    float accumulator = 0.0f;
-    std::uint64_t lastFrameTime = SDL_GetTicks64();
+    // The simulation runs on its own thread from here on, so a frame stuck in
+    // SDL_RenderPresent waiting for vsync no longer holds back the physics.
+    publishSnapshot(Profiler::Clock::now());
+    mSimulationThread = std::thread(&Application::simulate, this);
+    mNextFrame = Profiler::Clock::now();
 
-    while (mRunning) {
-        processEvents();
+    while (mRunning.load(std::memory_order_relaxed)) {
+        const Profiler::Scope frameScope(&mProfiler, "frame");
 
-        std::uint64_t currentFrameTime = SDL_GetTicks64();
-        float deltaTime = static_cast<float>(currentFrameTime - lastFrameTime) / 1000.0f;
-        lastFrameTime = currentFrameTime;
+        {
+            const Profiler::Scope scope(&mProfiler, "processEvents");
+            processEvents();
+        }
 
-        if (!mPaused) {
-            accumulator += deltaTime;
-            while (accumulator > fixedDeltaTime) {
-                fixedUpdate(fixedDeltaTime);
-                accumulator -= fixedDeltaTime;
-            }
-            update(deltaTime);
+        if (const std::uint32_t duration = mRumbleDuration.exchange(0, std::memory_order_relaxed); duration > 0) {
+            rumbleController(0xDEAD, 0xBEEF, duration);
         }
         render();
+        limitFrameRate();
     }
+    mSimulationThread.join();
 
+    if (mProfiler.isTracing()) {
+        saveTrace();
+    }
+
+    if (mRecorder && !mRecorder->save(mOptions.recordPath)) {
+        SDL_Log("Failed to save replay to %s", mOptions.recordPath.c_str());
+    }
+
+    if (mBrickLayer) {
+        SDL_DestroyTexture(mBrickLayer);
+    }
+    if (mFramebuffer) {
+        SDL_DestroyTexture(mFramebuffer);
+    }
     SDL_DestroyRenderer(mRenderer);
     SDL_DestroyWindow(mWindow);
     SDL_Quit();
 }
 
+void Application::simulate() {
+    using Clock = Profiler::Clock;
+    const float fixedDeltaTime = 1.0f / mOptions.tickRate;
+    const auto tickDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / mOptions.tickRate));
+    const std::uint32_t maxCatchUpSteps = std::max<std::uint32_t>(mOptions.maxCatchUpSteps, 1);
+
+    Clock::time_point nextTick = Clock::now() + tickDuration;
+    while (mRunning.load(std::memory_order_relaxed)) {
+        std::this_thread::sleep_until(nextTick);
+        if (mMemoryReportRequested.exchange(false, std::memory_order_relaxed)) {
+            logMemoryReport();
+        }
+
+        const Clock::time_point now = Clock::now();
+        if (mPaused.load(std::memory_order_relaxed)) {
+            readInputEvents(now);
+            nextTick = now + tickDuration;
+            continue;
+        }
+
+        // When more steps are due than may run at once (a loaded machine, a
+        // debugger break), the oldest are dropped so the game slows down
+        // instead of replaying them in a burst that puts it further behind.
+        const Clock::duration behind = now - nextTick;
+        const std::uint64_t due = behind < Clock::duration::zero() ? 0 : static_cast<std::uint64_t>(behind / tickDuration) + 1;
+        const std::uint64_t dropped = due > maxCatchUpSteps ? due - maxCatchUpSteps : 0;
+        nextTick += tickDuration * static_cast<Clock::rep>(dropped);
+        mProfiler.count("droppedSteps", static_cast<double>(dropped));
+
+        const Profiler::Scope scope(&mProfiler, "fixedUpdate");
+        std::uint32_t steps = 0;
+        Clock::time_point stepTime = nextTick;
+        for (; nextTick <= now; nextTick += tickDuration) {
+            readInputEvents(nextTick);
+            if (mOptions.interpolate && nextTick + tickDuration > now) {
+                recordPreviousPositions();
+            }
+            fixedUpdate(fixedDeltaTime);
+            stepTime = nextTick;
+            ++steps;
+        }
+        mProfiler.count("fixedSteps", steps);
+        publishSnapshot(stepTime);
+    }
+}
+
 void Application::processEvents() {
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
         switch (event.type) {
             case SDL_QUIT:
-                mRunning = false;
+                mRunning.store(false, std::memory_order_relaxed);
                 break;
 
             case SDL_CONTROLLERDEVICEADDED:
@@ -93,12 +220,72 @@ void Application::processEvents() {
                 handleEventControllerButtonUp(event);
                 break;
 
+            case SDL_RENDER_TARGETS_RESET:
+                mBrickLayerDirty = true;
+                break;
+
+            case SDL_RENDER_DEVICE_RESET:
+                // Textures are lost with the device; both are recreated on the next frame.
+                if (mBrickLayer) {
+                    SDL_DestroyTexture(mBrickLayer);
+                    mBrickLayer = nullptr;
+                }
+                if (mFramebuffer) {
+                    SDL_DestroyTexture(mFramebuffer);
+                    mFramebuffer = nullptr;
+                }
+                mBrickLayerDirty = true;
+                break;
+
             default:
                 break;
         }
     }
 }
 
+void Application::pushInput(InputEvent::Type type, std::uint8_t state, std::int32_t code, std::uint32_t timestamp) {
+    // SDL stamps events in milliseconds of SDL_GetTicks(); moved onto the
+    // profiler clock they are accurate to a millisecond.
+    const std::uint32_t age = std::min<std::uint32_t>(SDL_GetTicks() - timestamp, 1000);
+    const InputEvent inputEvent{type, state, code, Profiler::Clock::now() - std::chrono::milliseconds(age)};
+    // The simulation drains the queue every tick, so it only fills up when that thread is stuck.
+    if (!mInputQueue.push(inputEvent)) {
+        SDL_Log("Input queue full, dropping input");
+    }
+}
+
+void Application::readInputEvents(Profiler::Clock::time_point stepTime) {
+    InputEvent inputEvent{};
+    while (mInputQueue.peek(inputEvent)) {
+        // With timestamps an event waits for the first step at or after the
+        // moment it happened, instead of landing on whichever step runs next.
+        if (mOptions.inputTimestamps && inputEvent.time > stepTime) {
+            break;
+        }
+        mInputQueue.pop(inputEvent);
+
+        switch (inputEvent.type) {
+            case InputEvent::Type::Key:
+                if (inputEvent.code >= 0 && inputEvent.code < SDL_NUM_SCANCODES) {
+                    mKeyboardKeys[static_cast<std::size_t>(inputEvent.code)] = inputEvent.state != 0;
+                }
+                mProfiler.record("inputLatency", inputEvent.time, Profiler::Clock::now());
+                break;
+
+            case InputEvent::Type::ControllerButton:
+                if (inputEvent.code >= 0 && inputEvent.code < SDL_CONTROLLER_BUTTON_MAX) {
+                    mGameControllerButtons[static_cast<std::size_t>(inputEvent.code)] = inputEvent.state != 0;
+                }
+                mProfiler.record("inputLatency", inputEvent.time, Profiler::Clock::now());
+                break;
+
+            case InputEvent::Type::ControllerConnected:
+                mGameControllerConnected = inputEvent.state != 0;
+                break;
+        }
+    }
+}
+
 void Application::handleEventControllerDeviceAdded(const SDL_Event &event) {
     if (SDL_IsGameController(event.cdevice.which)) {
         mGameController = SDL_GameControllerOpen(event.cdevice.which);
@@ -106,6 +293,7 @@ void Application::handleEventControllerDeviceAdded(const SDL_Event &event) {
             SDL_Log("Failed to open game controller: %s", SDL_GetError());
             std::exit(EXIT_FAILURE);
         }
+        pushInput(InputEvent::Type::ControllerConnected, 1, 0, event.cdevice.timestamp);
     }
 }
 
@@ -113,398 +301,400 @@ void Application::handleEventControllerDeviceRemoved(const SDL_Event &event) {
     if (SDL_IsGameController(event.cdevice.which)) {
         SDL_GameControllerClose(mGameController);
         mGameController = nullptr;
+        pushInput(InputEvent::Type::ControllerConnected, 0, 0, event.cdevice.timestamp);
     }
 }
 
 void Application::handleEventKeyDown(const SDL_Event &event) {
     if (event.key.keysym.sym == SDLK_ESCAPE) {
-        mPaused = !mPaused;
+        mPaused.store(!mPaused.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    if (event.key.keysym.sym == SDLK_F1 && !event.key.repeat) {
+        mProfilerOverlay = !mProfilerOverlay;
     }
-    mKeyboardKeys[event.key.keysym.sym] = event.key.state;
+    if (event.key.keysym.sym == SDLK_F2 && !event.key.repeat) {
+        if (mProfiler.isTracing()) {
+            saveTrace();
+        } else {
+            SDL_Log("Capturing trace, press F2 again to save it");
+            mProfiler.beginTrace();
+        }
+    }
+    if (event.key.keysym.sym == SDLK_F3 && !event.key.repeat) {
+        mMemoryReportRequested.store(true, std::memory_order_relaxed);
+    }
+    pushInput(InputEvent::Type::Key, event.key.state, event.key.keysym.scancode, event.key.timestamp);
 }
 
 void Application::handleEventKeyUp(const SDL_Event &event) {
-    mKeyboardKeys[event.key.keysym.sym] = event.key.state;
+    pushInput(InputEvent::Type::Key, event.key.state, event.key.keysym.scancode, event.key.timestamp);
 }
 
 void Application::handleEventControllerButtonDown(const SDL_Event &event) {
     if (event.cbutton.button == SDL_CONTROLLER_BUTTON_START) {
-        mPaused = !mPaused;
+        mPaused.store(!mPaused.load(std::memory_order_relaxed), std::memory_order_relaxed);
     }
-    mGameControllerButtons[event.cbutton.button] = event.cbutton.state;
+    pushInput(InputEvent::Type::ControllerButton, event.cbutton.state, event.cbutton.button, event.cbutton.timestamp);
 }
 
 void Application::handleEventControllerButtonUp(const SDL_Event &event) {
-    mGameControllerButtons[event.cbutton.button] = event.cbutton.state;
+    pushInput(InputEvent::Type::ControllerButton, event.cbutton.state, event.cbutton.button, event.cbutton.timestamp);
 }
 
 void Application::fixedUpdate([[maybe_unused]] float fixedDeltaTime) {
-    updatePositions(fixedDeltaTime);
-    checkCollisions();
-}
-
-void Application::update([[maybe_unused]] float deltaTime) {
-    if (!mGameOver) {
-        bool flag = false;
-        auto view = mRegistry.view<Component::Tag>();
-        view.each([&](entt::entity, const Component::Tag &tag) {
-            if (tag.name == "Brick") {
-                flag = true;
-            }
-        });
-        if (!flag) {
-            mGameOver = !mGameOver;
-        }
-    } else {
-        mGameOver = !mGameOver;
-        respawnGoal();
-        respawnWalls();
-        respawnBricks();
-        respawnBalls();
-        respawnPaddles();
+    // Game over is handled every step rather than every frame so that replays are exact.
+    const Simulation::Input input = readInput();
+    if (mRecorder) {
+        mRecorder->record(input);
     }
-}
-
-void Application::render() {
-    SDL_SetRenderDrawColor(mRenderer, 0, 0, 0, 255);
-    SDL_RenderClear(mRenderer);
+    mSimulation.fixedUpdate(fixedDeltaTime, input);
+    if (mRecorder && mRecorder->isCheckpointDue()) {
+        mRecorder->checkpoint(mSimulation.getStateHash());
+    }
+    mSimulation.update();
 
-    renderGoal();
-    renderWalls();
-    renderBricks();
-    renderBalls();
-    renderPaddles();
+    {
+        // Purely visual, so it runs after the recorded step and is never replayed.
+        const Profiler::Scope scope(&mProfiler, "particles");
+        mParticles.update(fixedDeltaTime, mParticleThreads.get());
+    }
 
-    SDL_RenderPresent(mRenderer);
+    if (const std::uint32_t duration = mSimulation.consumeRumble(); duration > 0) {
+        std::uint32_t pending = mRumbleDuration.load(std::memory_order_relaxed);
+        while (pending < duration && !mRumbleDuration.compare_exchange_weak(pending, duration, std::memory_order_relaxed)) {
+        }
+    }
 }
 
-void Application::renderGoal() {
-    auto view = mRegistry.view<Component::Tag, Component::Transform>();
-    view.each([this](entt::entity, const Component::Tag &tag, const Component::Transform &transform) {
-        if (tag.name == "Goal") {
-            SDL_Rect rect{static_cast<int>(transform.position.x), static_cast<int>(transform.position.y), static_cast<int>(transform.scale.x), static_cast<int>(transform.scale.y)};
-            SDL_SetRenderDrawColor(mRenderer, 0, 0, 0, 255);
-            SDL_RenderFillRect(mRenderer, &rect);
-        }
+void Application::recordPreviousPositions() {
+    mPreviousPositions.clear();
+    const entt::registry &registry = mSimulation.getRegistry();
+    registry.view<const Component::Ball, const Component::Transform>().each([this](entt::entity entity, const Component::Transform &transform) {
+        mPreviousPositions.emplace_back(entity, transform.position);
+    });
+    registry.view<const Component::Paddle, const Component::Transform>().each([this](entt::entity entity, const Component::Transform &transform) {
+        mPreviousPositions.emplace_back(entity, transform.position);
     });
 }
 
-void Application::renderWalls() {
-    auto view = mRegistry.view<Component::Tag, Component::Transform>();
-    view.each([this](entt::entity, const Component::Tag &tag, const Component::Transform &transform) {
-        if (tag.name == "Wall") {
-            SDL_Rect rect{static_cast<int>(transform.position.x), static_cast<int>(transform.position.y), static_cast<int>(transform.scale.x), static_cast<int>(transform.scale.y)};
-            SDL_SetRenderDrawColor(mRenderer, 0, 0, 0, 255);
-            SDL_RenderFillRect(mRenderer, &rect);
+void Application::publishSnapshot(Profiler::Clock::time_point time) {
+    const Profiler::Scope scope(&mProfiler, "publishSnapshot");
+
+    Snapshot &snapshot = mSnapshots.getWriteBuffer();
+    snapshot.step = mSimulation.getSteps();
+    snapshot.time = time;
+    snapshot.shapes.clear();
+    const entt::registry &registry = mSimulation.getRegistry();
+    // Entities are visited in the order they were recorded unless the step
+    // created or destroyed some; shapes that cannot be matched do not move.
+    std::size_t previous = 0;
+    const auto addMovingShape = [&](entt::entity entity, const Component::Transform &transform, const Component::Sprite &sprite) {
+        Snapshot::Shape shape{toRect(transform), toColor(sprite.color), true};
+        if (previous < mPreviousPositions.size() && mPreviousPositions[previous].first == entity) {
+            const glm::vec2 offset = mPreviousPositions[previous].second - transform.position;
+            shape.previousOffset = SDL_FPoint{offset.x, offset.y};
         }
+        ++previous;
+        snapshot.shapes.push_back(shape);
+    };
+    registry.view<const Component::Goal, const Component::Transform>().each([&](entt::entity, const Component::Transform &transform) {
+        snapshot.shapes.push_back(Snapshot::Shape{toRect(transform), SDL_Color{0, 0, 0, 255}, false});
     });
+    registry.view<const Component::Wall, const Component::Transform>().each([&](entt::entity, const Component::Transform &transform) {
+        snapshot.shapes.push_back(Snapshot::Shape{toRect(transform), SDL_Color{0, 0, 0, 255}, false});
+    });
+    registry.view<const Component::Ball, const Component::Transform, const Component::Sprite>().each(addMovingShape);
+    registry.view<const Component::Paddle, const Component::Transform, const Component::Sprite>().each(addMovingShape);
+
+    // The buffer was last written a couple of snapshots ago: copy the bricks
+    // only after a respawn and otherwise just the bricks destroyed since.
+    if (snapshot.brickGeneration != mBrickGeneration) {
+        snapshot.brickGeneration = mBrickGeneration;
+        snapshot.bricks = mBricks;
+        snapshot.destroyedBricks = mDestroyedBricks;
+    } else {
+        snapshot.destroyedBricks.insert(snapshot.destroyedBricks.end(), mDestroyedBricks.begin() + static_cast<std::ptrdiff_t>(snapshot.destroyedBricks.size()), mDestroyedBricks.end());
+    }
+    mParticles.copyTo(snapshot.particleX, snapshot.particleY, snapshot.particleColors);
+    mProfiler.count("particles", static_cast<double>(mParticles.size()));
+    mSnapshots.publish();
 }
 
-void Application::renderBricks() {
-    auto view = mRegistry.view<Component::Tag, Component::Transform, Component::Sprite>();
-    view.each([this](entt::entity, const Component::Tag &tag, const Component::Transform &transform, const Component::Sprite &sprite) {
-        if (tag.name == "Brick") {
-            SDL_Rect rect{static_cast<int>(transform.position.x), static_cast<int>(transform.position.y), static_cast<int>(transform.scale.x), static_cast<int>(transform.scale.y)};
-            SDL_SetRenderDrawColor(mRenderer, static_cast<std::uint8_t>(sprite.color[0]), static_cast<std::uint8_t>(sprite.color[1]), static_cast<std::uint8_t>(sprite.color[2]), static_cast<std::uint8_t>(sprite.color[3]));
-            SDL_RenderFillRect(mRenderer, &rect);
-
-            SDL_Rect outlineRect{static_cast<int>(transform.position.x), static_cast<int>(transform.position.y), static_cast<int>(transform.scale.x), static_cast<int>(transform.scale.y)};
-            SDL_SetRenderDrawColor(mRenderer, static_cast<std::uint8_t>(sprite.color[0]) * 0.8f, static_cast<std::uint8_t>(sprite.color[1]) * 0.8f, static_cast<std::uint8_t>(sprite.color[2]) * 0.8f, static_cast<std::uint8_t>(sprite.color[3]) * 0.8f);
-            SDL_RenderDrawRect(mRenderer, &outlineRect);
-        }
-    });
+void Application::onBrickDestroyed(const Event::BrickDestroyed &event) {
+    mDestroyedBricks.push_back(toRect(event.transform));
+    if (mOptions.particlesPerBrick > 0) {
+        std::uint32_t packed = 0;
+        std::memcpy(&packed, &event.sprite.color, sizeof(packed));
+        mParticles.emit(event.transform.position, event.transform.scale, packed, mOptions.particlesPerBrick);
+    }
 }
 
-void Application::renderBalls() {
-    auto view = mRegistry.view<Component::Tag, Component::Transform, Component::Sprite>();
-    view.each([this](entt::entity, const Component::Tag &tag, const Component::Transform &transform, const Component::Sprite &sprite) {
-        if (tag.name == "Ball") {
-            SDL_Rect rect{static_cast<int>(transform.position.x), static_cast<int>(transform.position.y), static_cast<int>(transform.scale.x), static_cast<int>(transform.scale.y)};
-            SDL_SetRenderDrawColor(mRenderer, static_cast<std::uint8_t>(sprite.color[0]), static_cast<std::uint8_t>(sprite.color[1]), static_cast<std::uint8_t>(sprite.color[2]), static_cast<std::uint8_t>(sprite.color[3]));
-            SDL_RenderFillRect(mRenderer, &rect);
-
-            SDL_Rect outlineRect{static_cast<int>(transform.position.x), static_cast<int>(transform.position.y), static_cast<int>(transform.scale.x), static_cast<int>(transform.scale.y)};
-            SDL_SetRenderDrawColor(mRenderer, static_cast<std::uint8_t>(sprite.color[0]) * 0.8f, static_cast<std::uint8_t>(sprite.color[1]) * 0.8f, static_cast<std::uint8_t>(sprite.color[2]) * 0.8f, static_cast<std::uint8_t>(sprite.color[3]));
-            SDL_RenderDrawRect(mRenderer, &outlineRect);
-        }
-    });
+void Application::logMemoryReport() {
+    std::size_t total = 0;
+    SDL_Log("%-32s %10s %10s %12s", "storage", "size", "capacity", "bytes");
+    for (const Simulation::StorageUsage &usage: mSimulation.getStorageUsage()) {
+        SDL_Log("%-32.*s %10zu %10zu %12zu", static_cast<int>(usage.name.size()), usage.name.data(), usage.size, usage.capacity, usage.bytes);
+        total += usage.bytes;
+    }
+    const BrickField &brickField = mSimulation.getBrickField();
+    SDL_Log("%-32s %10zu %10u %12zu", "BrickField", brickField.getAliveCount(), brickField.getCellCount(), brickField.getByteSize());
+    total += brickField.getByteSize();
+    SDL_Log("%-32s %10s %10s %12zu", "total", "", "", total);
 }
 
-void Application::renderPaddles() {
-    auto view = mRegistry.view<Component::Tag, Component::Transform, Component::Sprite>();
-    view.each([this](entt::entity, const Component::Tag &tag, const Component::Transform &transform, const Component::Sprite &sprite) {
-        if (tag.name == "Paddle") {
-            SDL_Rect rect{static_cast<int>(transform.position.x), static_cast<int>(transform.position.y), static_cast<int>(transform.scale.x), static_cast<int>(transform.scale.y)};
-            SDL_SetRenderDrawColor(mRenderer, static_cast<std::uint8_t>(sprite.color[0]), static_cast<std::uint8_t>(sprite.color[1]), static_cast<std::uint8_t>(sprite.color[2]), static_cast<std::uint8_t>(sprite.color[3]));
-            SDL_RenderFillRect(mRenderer, &rect);
-
-            SDL_Rect outlineRect{static_cast<int>(transform.position.x), static_cast<int>(transform.position.y), static_cast<int>(transform.scale.x), static_cast<int>(transform.scale.y)};
-            SDL_SetRenderDrawColor(mRenderer, static_cast<std::uint8_t>(sprite.color[0]) * 0.8f, static_cast<std::uint8_t>(sprite.color[1]) * 0.8f, static_cast<std::uint8_t>(sprite.color[2]) * 0.8f, static_cast<std::uint8_t>(sprite.color[3]));
-            SDL_RenderDrawRect(mRenderer, &outlineRect);
-        }
+void Application::onBricksRespawned(const Event::BricksRespawned &) {
+    // Restored entities keep their ids; without this they would slide from
+    // where they were lost to their spawn point instead of jumping there.
+    mPreviousPositions.clear();
+    ++mBrickGeneration;
+    mDestroyedBricks.clear();
+    mBricks.clear();
+    mSimulation.getRegistry().view<Component::Brick, Component::Transform, Component::Sprite>().each([this](entt::entity, const Component::Transform &transform, const Component::Sprite &sprite) {
+        mBricks.push_back(Snapshot::Shape{toRect(transform), toColor(sprite.color), true});
+    });
+    const BrickField &brickField = mSimulation.getBrickField();
+    brickField.forEachAlive([&](std::uint32_t cell) {
+        mBricks.push_back(Snapshot::Shape{toRect(brickField.getTransform(cell)), toColor(brickField.getColor(cell)), true});
     });
 }
 
-void Application::respawnGoal() {
-    auto view = mRegistry.view<Component::Tag>();
-    view.each([this](entt::entity entity, const Component::Tag &tag) {
-        if (tag.name == "Goal") {
-            mRegistry.destroy(entity);
-        }
-    });
+void Application::render() {
+    const Profiler::Scope renderScope(&mProfiler, "render");
 
-    entt::entity entity2 = mRegistry.create();
-    mRegistry.emplace<Component::Tag>(entity2, "Goal");
-    mRegistry.emplace<Component::Transform>(entity2, glm::vec2(0.0f, 600.0f), glm::vec2(0.0f, 0.0f), glm::vec2(800.0f, 20.0f));
-}
+    mSnapshots.update();
+    const Snapshot &snapshot = mSnapshots.getReadBuffer();
 
-void Application::respawnWalls() {
-    auto view = mRegistry.view<Component::Tag>();
-    view.each([this](entt::entity entity, const Component::Tag &tag) {
-        if (tag.name == "Wall") {
-            mRegistry.destroy(entity);
-        }
-    });
+    const float alpha = getInterpolation(snapshot);
+    mRenderBatch.resetSubmissions();
+    mRenderBatch.clear();
+    if (mOptions.softwareRenderer) {
+        rasterize(snapshot, alpha);
+    } else {
+        updateBrickLayer(snapshot);
 
-    entt::entity entity1 = mRegistry.create();
-    mRegistry.emplace<Component::Tag>(entity1, "Wall");
-    mRegistry.emplace<Component::Transform>(entity1, glm::vec2(0.0f, -20.0f), glm::vec2(0.0f, 0.0f), glm::vec2(800.0f, 20.0f));
+        SDL_SetRenderDrawColor(mRenderer, 0, 0, 0, 255);
+        SDL_RenderClear(mRenderer);
 
-    entt::entity entity3 = mRegistry.create();
-    mRegistry.emplace<Component::Tag>(entity3, "Wall");
-    mRegistry.emplace<Component::Transform>(entity3, glm::vec2(-20.0f, 0.0f), glm::vec2(0.0f, 0.0f), glm::vec2(20.0f, 600.0f));
+        if (mBrickLayer) {
+            SDL_RenderCopy(mRenderer, mBrickLayer, nullptr, nullptr);
+        } else {
+            const Profiler::Scope scope(&mProfiler, "renderBricks");
+            renderBricks(snapshot);
+        }
+        renderShapes(snapshot, alpha);
+        renderParticles(snapshot);
+    }
+    if (mProfilerOverlay) {
+        renderProfilerOverlay();
+    }
+    {
+        const Profiler::Scope scope(&mProfiler, "submit");
+        mRenderBatch.submit(mRenderer);
+    }
+    mProfiler.count("drawCalls", mRenderBatch.getSubmissions());
 
-    entt::entity entity4 = mRegistry.create();
-    mRegistry.emplace<Component::Tag>(entity4, "Wall");
-    mRegistry.emplace<Component::Transform>(entity4, glm::vec2(800.0f, 0.0f), glm::vec2(0.0f, 0.0f), glm::vec2(20.0f, 600.0f));
+    const Profiler::Scope scope(&mProfiler, "present");
+    SDL_RenderPresent(mRenderer);
 }
 
-void Application::respawnBricks() {
-    const std::map<std::uint8_t, glm::vec4> colors{
-            {0, glm::vec4{194, 57, 52, 255}},  // Red
-            {1, glm::vec4{255, 167, 38, 255}}, // Orange
-            {2, glm::vec4{255, 255, 100, 255}},// Yellow
-            {3, glm::vec4{78, 188, 78, 255}},  // Green
-            {4, glm::vec4{46, 116, 181, 255}}, // Blue
-            {5, glm::vec4{216, 64, 185, 255}}, // Purple
-            {6, glm::vec4{255, 105, 180, 255}},// Pink
-            {7, glm::vec4{128, 128, 128, 255}} // Gray
-    };
-
-    const std::uint8_t rows = 8;
-    const std::uint8_t cols = 10;
+float Application::getInterpolation(const Snapshot &snapshot) const {
+    if (!mOptions.interpolate) {
+        return 1.0f;
+    }
+    const std::chrono::duration<float> sinceStep = Profiler::Clock::now() - snapshot.time;
+    return std::clamp(sinceStep.count() * mOptions.tickRate, 0.0f, 1.0f);
+}
 
-    auto view = mRegistry.view<Component::Tag>();
-    view.each([this](entt::entity entity, const Component::Tag &tag) {
-        if (tag.name == "Brick") {
-            mRegistry.destroy(entity);
+void Application::updateBrickLayer(const Snapshot &snapshot) {
+    if (!mBrickLayer) {
+        if (!mBrickLayerSupported) {
+            return;
         }
-    });
-
-    for (std::uint8_t row = 0; row < rows; ++row) {
-        for (std::uint8_t col = 0; col < cols; ++col) {
-            entt::entity entity = mRegistry.create();
-            mRegistry.emplace<Component::Tag>(entity, "Brick");
-            mRegistry.emplace<Component::Transform>(entity, glm::vec2(static_cast<float>(col) * 80.0f, static_cast<float>(row) * 20.0f), glm::vec2(0.0f, 0.0f), glm::vec2(80.0f, 20.0f));
-            mRegistry.emplace<Component::Sprite>(entity, colors.at(row));
+        mBrickLayer = SDL_CreateTexture(mRenderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, 800, 600);
+        if (!mBrickLayer) {
+            SDL_Log("Failed to create brick layer, drawing bricks every frame: %s", SDL_GetError());
+            mBrickLayerSupported = false;
+            return;
         }
+        SDL_SetTextureBlendMode(mBrickLayer, SDL_BLENDMODE_NONE);
+        mBrickLayerDirty = true;
     }
-}
 
-void Application::respawnBalls() {
-    auto view = mRegistry.view<Component::Tag>();
-    view.each([this](entt::entity entity, const Component::Tag &tag) {
-        if (tag.name == "Ball") {
-            mRegistry.destroy(entity);
-        }
-    });
+    if (snapshot.brickGeneration != mBrickLayerGeneration) {
+        mBrickLayerDirty = true;
+    }
+    if (!mBrickLayerDirty && mBrickLayerDestroyed == snapshot.destroyedBricks.size()) {
+        return;
+    }
 
-    entt::entity entity = mRegistry.create();
-    mRegistry.emplace<Component::Tag>(entity, "Ball");
-    mRegistry.emplace<Component::Transform>(entity, 0.5f * glm::vec2(800.0f - 10.0f, 600.0f - 10.0f), glm::vec2(0.0f, 0.0f), glm::vec2(10.0f, 10.0f));
-    mRegistry.emplace<Component::Sprite>(entity, glm::vec4(255.0f, 255.0f, 255.0f, 255.0f));
-    mRegistry.emplace<Component::Movement>(entity, glm::vec2(200.0f, 200.0f));
-}
+    const Profiler::Scope scope(&mProfiler, "renderBricks");
 
-void Application::respawnPaddles() {
-    auto view = mRegistry.view<Component::Tag>();
-    view.each([this](entt::entity entity, const Component::Tag &tag) {
-        if (tag.name == "Paddle") {
-            mRegistry.destroy(entity);
-        }
-    });
+    SDL_SetRenderTarget(mRenderer, mBrickLayer);
+    SDL_SetRenderDrawColor(mRenderer, 0, 0, 0, 255);
+    if (mBrickLayerDirty) {
+        SDL_RenderClear(mRenderer);
+        mRenderBatch.clear();
+        renderBricks(snapshot);
+        mRenderBatch.submit(mRenderer);
+        // The bricks are in the layer now; the frame must not draw them again.
+        mRenderBatch.clear();
+    } else {
+        // Bricks never overlap, so clearing a destroyed brick's rectangle leaves its neighbours intact.
+        SDL_RenderFillRects(mRenderer, snapshot.destroyedBricks.data() + mBrickLayerDestroyed, static_cast<int>(snapshot.destroyedBricks.size() - mBrickLayerDestroyed));
+    }
+    SDL_SetRenderTarget(mRenderer, nullptr);
 
-    entt::entity entity = mRegistry.create();
-    mRegistry.emplace<Component::Tag>(entity, "Paddle");
-    mRegistry.emplace<Component::Transform>(entity, glm::vec2(0.5f * (800.0f - 80.0f), 600.0f - 20.0f), glm::vec2(0.0f, 0.0f), glm::vec2(80.0f, 20.0f));
-    mRegistry.emplace<Component::Sprite>(entity, glm::vec4(255.0f, 255.0f, 255.0f, 255.0f));
-    mRegistry.emplace<Component::Movement>(entity, glm::vec2(400.0f, 0.0f));
+    mBrickLayerDirty = false;
+    mBrickLayerGeneration = snapshot.brickGeneration;
+    mBrickLayerDestroyed = snapshot.destroyedBricks.size();
 }
 
-void Application::rumbleController(std::uint16_t low_frequency_rumble, std::uint16_t high_frequency_rumble, std::uint32_t duration_ms) {
-    if (mGameController) {
-        SDL_GameControllerRumble(mGameController, low_frequency_rumble, high_frequency_rumble, duration_ms);
+void Application::renderBricks(const Snapshot &snapshot) {
+    for (const Snapshot::Shape &brick: snapshot.bricks) {
+        mRenderBatch.fillRect(brick.rect, brick.color);
+        mRenderBatch.drawRect(brick.rect, toOutlineColor(brick.color));
+    }
+    for (const SDL_Rect &rect: snapshot.destroyedBricks) {
+        mRenderBatch.fillRect(rect, SDL_Color{0, 0, 0, 255});
     }
 }
 
-void Application::updatePositions(float fixedDeltaTime) {
-    auto ballView = mRegistry.view<Component::Tag, Component::Transform, Component::Movement>();
-    ballView.each([&](entt::entity, const Component::Tag &tag, Component::Transform &ballTransform, Component::Movement &ballMovement) {
-        if (tag.name == "Ball") {
-            ballTransform.position.x += ballMovement.velocity.x * fixedDeltaTime;
-            ballTransform.position.y += ballMovement.velocity.y * fixedDeltaTime;
-        }
-    });
+void Application::renderShapes(const Snapshot &snapshot, float alpha) {
+    const Profiler::Scope scope(&mProfiler, "renderShapes");
 
-    auto paddleView = mRegistry.view<Component::Tag, Component::Transform, Component::Movement>();
-    paddleView.each([&](entt::entity, const Component::Tag &tag, Component::Transform &paddleTransform, Component::Movement &paddleMovement) {
-        if (tag.name == "Paddle") {
-            auto goalView = mRegistry.view<Component::Tag, Component::Transform>();
-            goalView.each([&](entt::entity, const Component::Tag &tag, const Component::Transform &goalTransform) {
-                if (tag.name == "Goal") {
-                    if (paddleTransform.position.x > 0.0f) {
-                        if (mKeyboardKeys[SDLK_LEFT]) {
-                            paddleTransform.position.x -= paddleMovement.velocity.x * fixedDeltaTime;
-                        }
-                        if (mGameController && mGameControllerButtons[SDL_CONTROLLER_BUTTON_DPAD_LEFT]) {
-                            paddleTransform.position.x -= paddleMovement.velocity.x * fixedDeltaTime;
-                        }
-                    }
-                    if (paddleTransform.position.x + paddleTransform.scale.x < goalTransform.scale.x) {
-                        if (mKeyboardKeys[SDLK_RIGHT]) {
-                            paddleTransform.position.x += paddleMovement.velocity.x * fixedDeltaTime;
-                        }
-                        if (mGameController && mGameControllerButtons[SDL_CONTROLLER_BUTTON_DPAD_RIGHT]) {
-                            paddleTransform.position.x += paddleMovement.velocity.x * fixedDeltaTime;
-                        }
-                    }
-                }
-            });
+    for (const Snapshot::Shape &shape: snapshot.shapes) {
+        const SDL_Rect rect = shape.interpolate(alpha);
+        mRenderBatch.fillRect(rect, shape.color);
+        if (shape.outline) {
+            mRenderBatch.drawRect(rect, toOutlineColor(shape.color));
         }
-    });
+    }
 }
 
-void Application::checkCollisions() {
-    auto ballView = mRegistry.view<Component::Tag, Component::Transform, Component::Movement>();
-    ballView.each([&](entt::entity, const Component::Tag &tag, Component::Transform &ballTransform, Component::Movement &ballMovement) {
-        if (tag.name == "Ball") {
-            auto goalView = mRegistry.view<Component::Tag, Component::Transform>();
-            goalView.each([&](entt::entity, const Component::Tag &tag, const Component::Transform &goalTransform) {
-                if (tag.name == "Goal") {
-                    switch (checkAABBCollision(ballTransform, goalTransform)) {
-                        using enum CollisionLocation;
-                        case Top:
-                        case Bottom:
-                            mGameOver = !mGameOver;
-                            rumbleController(0xDEAD, 0xBEEF, 100);
-                            ballMovement.velocity.y *= -1.0f;
-                            break;
-                        case Left:
-                        case Right:
-                            mGameOver = !mGameOver;
-                            rumbleController(0xDEAD, 0xBEEF, 100);
-                            ballMovement.velocity.x *= -1.0f;
-                            break;
-                        default:
-                            break;
-                    }
-                }
-            });
-
-            auto wallView = mRegistry.view<Component::Tag, Component::Transform>();
-            wallView.each([&](entt::entity, const Component::Tag &tag, const Component::Transform &wallTransform) {
-                if (tag.name == "Wall") {
-                    switch (checkAABBCollision(ballTransform, wallTransform)) {
-                        using enum CollisionLocation;
-                        case Top:
-                        case Bottom:
-                            rumbleController(0xDEAD, 0xBEEF, 100);
-                            ballMovement.velocity.y *= -1.0f;
-                            break;
-                        case Left:
-                        case Right:
-                            rumbleController(0xDEAD, 0xBEEF, 100);
-                            ballMovement.velocity.x *= -1.0f;
-                            break;
-                        default:
-                            break;
-                    }
-                }
-            });
-
-            auto brickView = mRegistry.view<Component::Tag, Component::Transform>();
-            brickView.each([&](entt::entity entity, const Component::Tag &tag, const Component::Transform &brickTransform) {
-                if (tag.name == "Brick") {
-                    switch (checkAABBCollision(ballTransform, brickTransform)) {
-                        using enum CollisionLocation;
-                        case Top:
-                        case Bottom:
-                            rumbleController(0xDEAD, 0xBEEF, 200);
-                            mRegistry.destroy(entity);
-                            ballMovement.velocity.y *= -1.0f;
-                            break;
-                        case Left:
-                        case Right:
-                            rumbleController(0xDEAD, 0xBEEF, 200);
-                            mRegistry.destroy(entity);
-                            ballMovement.velocity.x *= -1.0f;
-                            break;
-                        default:
-                            break;
-                    }
-                }
-            });
-
-            auto paddleView = mRegistry.view<Component::Tag, Component::Transform>();
-            paddleView.each([&](entt::entity, const Component::Tag &tag, const Component::Transform &paddleTransform) {
-                if (tag.name == "Paddle") {
-                    switch (checkAABBCollision(ballTransform, paddleTransform)) {
-                        using enum CollisionLocation;
-                        case Top:
-                        case Bottom:
-                            rumbleController(0xDEAD, 0xBEEF, 100);
-                            ballMovement.velocity.y *= -1.0f;
-                            break;
-                        case Left:
-                        case Right:
-                            rumbleController(0xDEAD, 0xBEEF, 100);
-                            ballMovement.velocity.x *= -1.0f;
-                            break;
-                        default:
-                            break;
-                    }
-                }
-            });
-        }
-    });
+void Application::renderParticles(const Snapshot &snapshot) {
+    const Profiler::Scope scope(&mProfiler, "renderParticles");
+    mRenderBatch.fillSquares(snapshot.particleX.data(), snapshot.particleY.data(), snapshot.particleColors.data(), snapshot.particleColors.size(), static_cast<float>(particleSize));
 }
 
-Application::CollisionLocation Application::checkAABBCollision(const Component::Transform &transformA, const Component::Transform &transformB) {
-    const glm::vec2 minAPosition = transformA.position;
-    const glm::vec2 minBPosition = transformB.position;
+void Application::rasterize(const Snapshot &snapshot, float alpha) {
+    const Profiler::Scope scope(&mProfiler, "rasterize");
 
-    const glm::vec2 maxAPosition = transformA.position + transformA.scale;
-    const glm::vec2 maxBPosition = transformB.position + transformB.scale;
+    if (!mFramebuffer) {
+        mFramebuffer = SDL_CreateTexture(mRenderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STREAMING, 800, 600);
+        if (!mFramebuffer) {
+            SDL_Log("Failed to create framebuffer, falling back to the SDL renderer: %s", SDL_GetError());
+            mOptions.softwareRenderer = false;
+            return;
+        }
+    }
 
-    using enum CollisionLocation;
+    // Draws straight into the texture's memory; SDL uploads it on unlock.
+    void *pixels = nullptr;
+    int pitch = 0;
+    if (SDL_LockTexture(mFramebuffer, nullptr, &pixels, &pitch) < 0) {
+        SDL_Log("Failed to lock framebuffer: %s", SDL_GetError());
+        return;
+    }
+    mRasterizer.setTarget(static_cast<std::uint8_t *>(pixels), 800, 600, pitch, Rasterizer::Format::RGBA8);
+    mRasterizer.clear(Rasterizer::Color{0, 0, 0, 255});
+    for (const Snapshot::Shape &brick: snapshot.bricks) {
+        mRasterizer.fillRect(toRasterRect(brick.rect), toRasterColor(brick.color));
+        mRasterizer.drawRect(toRasterRect(brick.rect), toRasterColor(toOutlineColor(brick.color)));
+    }
+    for (const SDL_Rect &rect: snapshot.destroyedBricks) {
+        mRasterizer.fillRect(toRasterRect(rect), Rasterizer::Color{0, 0, 0, 255});
+    }
+    for (const Snapshot::Shape &shape: snapshot.shapes) {
+        const Rasterizer::Rect rect = toRasterRect(shape.interpolate(alpha));
+        mRasterizer.fillRect(rect, toRasterColor(shape.color));
+        if (shape.outline) {
+            mRasterizer.drawRect(rect, toRasterColor(toOutlineColor(shape.color)));
+        }
+    }
+    for (std::size_t particle = 0; particle < snapshot.particleColors.size(); ++particle) {
+        Rasterizer::Color color{};
+        std::memcpy(&color, &snapshot.particleColors[particle], sizeof(color));
+        const Rasterizer::Rect rect{static_cast<int>(snapshot.particleX[particle]) - particleSize / 2, static_cast<int>(snapshot.particleY[particle]) - particleSize / 2, particleSize, particleSize};
+        mRasterizer.fillRect(rect, color);
+    }
+    SDL_UnlockTexture(mFramebuffer);
+    SDL_RenderCopy(mRenderer, mFramebuffer, nullptr, nullptr);
+}
 
-    if (maxAPosition.x > minBPosition.x && minAPosition.x < maxBPosition.x && maxAPosition.y > minBPosition.y && minAPosition.y < maxBPosition.y) {
-        const glm::vec2 overlap(glm::min(maxAPosition.x, maxBPosition.x) - glm::max(minAPosition.x, minBPosition.x), glm::min(maxAPosition.y, maxBPosition.y) - glm::max(minAPosition.y, minBPosition.y));
+void Application::limitFrameRate() {
+    if (mOptions.vsync || mOptions.maxFrameRate <= 0.0f) {
+        return;
+    }
+    using Clock = Profiler::Clock;
+    const auto frameDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / mOptions.maxFrameRate));
+    // sleep_until can overshoot by a scheduler tick, so the last stretch is spent yielding.
+    const auto spin = Clock::duration(std::chrono::milliseconds(1));
+
+    // A frame that ran late starts the schedule over rather than rushing the next ones.
+    const Clock::time_point now = Clock::now();
+    mNextFrame += frameDuration;
+    if (mNextFrame <= now) {
+        mNextFrame = now;
+        return;
+    }
 
-        if (const glm::vec2 ratio(overlap.x / transformA.scale.x, overlap.y / transformA.scale.y); ratio.x > ratio.y) {
-            if (maxAPosition.y < maxBPosition.y) {
-                return Top;
-            } else {
-                return Bottom;
-            }
+    const Profiler::Scope scope(&mProfiler, "limitFrameRate");
+    if (mNextFrame - now > spin) {
+        std::this_thread::sleep_until(mNextFrame - spin);
+    }
+    while (Clock::now() < mNextFrame) {
+        std::this_thread::yield();
+    }
+}
+
+void Application::renderProfilerOverlay() {
+    const std::vector<Profiler::Stats> stats = mProfiler.getStats();
+    const int scale = 2;
+    const int lineHeight = 6 * scale;
+    // The name column fits the longest name, followed by five 8 glyph columns.
+    int nameWidth = 16;
+    for (const Profiler::Stats &stat: stats) {
+        nameWidth = std::max(nameWidth, static_cast<int>(std::strlen(stat.name)));
+    }
+    const int width = (nameWidth + 5 * 8) * 4 * scale + 2 * scale;
+    const int height = static_cast<int>(stats.size() + 1) * lineHeight + 2 * scale;
+    const SDL_Rect background{4, 600 - 4 - height, width, height};
+    mRenderBatch.fillRect(background, SDL_Color{0, 0, 0, 255});
+
+    const SDL_Color color{255, 255, 100, 255};
+    int y = background.y + scale;
+    char line[128];
+    std::snprintf(line, sizeof(line), "%-*s %7s %7s %7s %7s %7s", nameWidth, "MS", "LAST", "MIN", "AVG", "P99", "MAX");
+    mRenderBatch.drawText(background.x + scale, y, line, color, scale);
+    for (const Profiler::Stats &stat: stats) {
+        y += lineHeight;
+        if (stat.counter) {
+            std::snprintf(line, sizeof(line), "%-*s %7.0f %7.0f %7.1f %7.0f %7.0f", nameWidth, stat.name, stat.last, stat.min, stat.average, stat.p99, stat.max);
         } else {
-            if (maxAPosition.x < maxBPosition.x) {
-                return Left;
-            } else {
-                return Right;
-            }
+            std::snprintf(line, sizeof(line), "%-*s %7.3f %7.3f %7.3f %7.3f %7.3f", nameWidth, stat.name, stat.last, stat.min, stat.average, stat.p99, stat.max);
         }
+        mRenderBatch.drawText(background.x + scale, y, line, color, scale);
     }
+}
 
-    return None;
-}
\ No newline at end of file
+void Application::saveTrace() {
+    const std::string path = mOptions.tracePath.empty() ? "breakout-trace.json" : mOptions.tracePath;
+    if (mProfiler.endTrace(path)) {
+        SDL_Log("Saved trace to %s", path.c_str());
+    } else {
+        SDL_Log("Failed to save trace to %s", path.c_str());
+    }
+}
+
+void Application::rumbleController(std::uint16_t low_frequency_rumble, std::uint16_t high_frequency_rumble, std::uint32_t duration_ms) {
+    if (mGameController) {
+        SDL_GameControllerRumble(mGameController, low_frequency_rumble, high_frequency_rumble, duration_ms);
+    }
+}
+
+Simulation::Input Application::readInput() {
+    Simulation::Input input;
+    input.left = mKeyboardKeys[SDL_SCANCODE_LEFT] || (mGameControllerConnected && mGameControllerButtons[SDL_CONTROLLER_BUTTON_DPAD_LEFT]);
+    input.right = mKeyboardKeys[SDL_SCANCODE_RIGHT] || (mGameControllerConnected && mGameControllerButtons[SDL_CONTROLLER_BUTTON_DPAD_RIGHT]);
+    return input;
+}
@@ -1,20 +1,124 @@
 #pragma once
 
 #include "Component.hpp"
+#include "ParticleSystem.hpp"
+#include "Profiler.hpp"
+#include "Rasterizer.hpp"
+#include "RenderBatch.hpp"
+#include "Replay.hpp"
+#include "Simulation.hpp"
+#include "SpscQueue.hpp"
+#include "ThreadPool.hpp"
+#include "TripleBuffer.hpp"
 
 #define SDL_MAIN_HANDLED
 #include <SDL2/SDL.h>
 
 #include <entt/entt.hpp>
 
-#include <map>
+#include <atomic>
+#include <bitset>
+#include <cmath>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 class Application {
 public:
+    struct Options {
+        float tickRate = 240.0f;
+        Simulation::Config simulation;
+        // Binary level to play instead of the built-in one when not empty.
+        std::string levelPath;
+        // Records every fixed step into this replay file when not empty.
+        std::string recordPath;
+        // Captures a Chrome trace of the whole session into this file when not empty.
+        std::string tracePath;
+        // Applies input at the fixed step matching its SDL event timestamp
+        // rather than at the first step after the event loop saw it.
+        bool inputTimestamps = false;
+        // Most fixed steps run to catch up in one go; time beyond them is dropped,
+        // slowing the game down instead of stalling it behind bursts of steps.
+        std::uint32_t maxCatchUpSteps = 8;
+        // Draws moving shapes between the last two fixed steps, one step behind.
+        bool interpolate = true;
+        bool vsync = true;
+        // Frames per second the render loop is held to without vsync; 0 for no limit.
+        float maxFrameRate = 0.0f;
+        // Draws frames with the CPU Rasterizer into a streaming texture
+        // instead of through SDL_Renderer geometry.
+        bool softwareRenderer = false;
+        // Debris particles sprayed by every destroyed brick; 0 turns them off.
+        std::uint32_t particlesPerBrick = 48;
+        // Live particles at most; emission beyond them is dropped.
+        std::size_t maxParticles = 100000;
+        // Logs the memory held by every component storage once the level is built.
+        bool memoryReport = false;
+    };
+
+    Application() = default;
+    explicit Application(const Options &options);
+
     void run();
 
 private:
+    // Everything render() needs from one fixed step, built on the simulation
+    // thread and handed to the render thread through mSnapshots.
+    struct Snapshot {
+        struct Shape {
+            SDL_Rect rect;
+            SDL_Color color;
+            bool outline;
+            // Position one step earlier minus the current one; zero for shapes that do not move.
+            SDL_FPoint previousOffset{0.0f, 0.0f};
+
+            // The rectangle alpha of the way from the previous step to this one.
+            [[nodiscard]] SDL_Rect interpolate(float alpha) const {
+                const float back = 1.0f - alpha;
+                return SDL_Rect{rect.x + static_cast<int>(std::lround(previousOffset.x * back)), rect.y + static_cast<int>(std::lround(previousOffset.y * back)), rect.w, rect.h};
+            }
+        };
+
+        std::uint64_t step = 0;
+        // When the step was due; frames drawn later interpolate towards it.
+        Profiler::Clock::time_point time;
+        // Goal, walls, balls and paddles in drawing order.
+        std::vector<Shape> shapes;
+        // Bricks as of the last respawn plus the ones destroyed since; the
+        // generation changes with every respawn.
+        std::uint64_t brickGeneration = 0;
+        std::vector<Shape> bricks;
+        std::vector<SDL_Rect> destroyedBricks;
+        // Live particles, drawn as they were at the step without interpolation.
+        std::vector<float> particleX;
+        std::vector<float> particleY;
+        std::vector<std::uint32_t> particleColors;
+    };
+
+    // Input change forwarded from the event loop to the simulation thread.
+    // Keys are scancodes.
+    struct InputEvent {
+        enum class Type : std::uint8_t {
+            Key,
+            ControllerButton,
+            ControllerConnected,
+        };
+
+        Type type;
+        std::uint8_t state;
+        std::int32_t code;
+        // When the event happened, from its SDL timestamp.
+        Profiler::Clock::time_point time;
+    };
+
+    void simulate();
     void processEvents();
+    void pushInput(InputEvent::Type type, std::uint8_t state, std::int32_t code, std::uint32_t timestamp);
+    // Applies the queued input that happened by stepTime.
+    void readInputEvents(Profiler::Clock::time_point stepTime);
 
     void handleEventControllerDeviceAdded(const SDL_Event &event);
     void handleEventControllerDeviceRemoved(const SDL_Event &event);
@@ -24,37 +128,72 @@ private:
     void handleEventControllerButtonUp(const SDL_Event &event);
 
     void fixedUpdate([[maybe_unused]] float fixedDeltaTime);
-    void update([[maybe_unused]] float deltaTime);
-    void render();
+    void recordPreviousPositions();
+    void publishSnapshot(Profiler::Clock::time_point time);
+    void onBrickDestroyed(const Event::BrickDestroyed &event);
+    void onBricksRespawned(const Event::BricksRespawned &event);
+    void logMemoryReport();
 
-    void renderGoal();
-    void renderWalls();
-    void renderBricks();
-    void renderBalls();
-    void renderPaddles();
+    void render();
+    // How far the frame about to be drawn is between the snapshot's step and the next one.
+    [[nodiscard]] float getInterpolation(const Snapshot &snapshot) const;
+    void updateBrickLayer(const Snapshot &snapshot);
+    void renderBricks(const Snapshot &snapshot);
+    void renderShapes(const Snapshot &snapshot, float alpha);
+    void renderParticles(const Snapshot &snapshot);
+    void rasterize(const Snapshot &snapshot, float alpha);
+    void limitFrameRate();
+    void renderProfilerOverlay();
 
-    void respawnGoal();
-    void respawnWalls();
-    void respawnBricks();
-    void respawnBalls();
-    void respawnPaddles();
+    void saveTrace();
 
     void rumbleController(std::uint16_t low_frequency_rumble, std::uint16_t high_frequency_rumble, std::uint32_t duration_ms);
 
-    enum class CollisionLocation { None, Top, Bottom, Left, Right };
-
-    void updatePositions(float fixedDeltaTime);
-    void checkCollisions();
-
-    static CollisionLocation checkAABBCollision(const Component::Transform &transformA, const Component::Transform &transformB);
+    Simulation::Input readInput();
 
+    // Render thread.
     SDL_Window *mWindow = nullptr;
     SDL_Renderer *mRenderer = nullptr;
+    RenderBatch mRenderBatch;
+    SDL_Texture *mBrickLayer = nullptr;
+    bool mBrickLayerSupported = true;
+    // Target of the software renderer, written through SDL_LockTexture.
+    SDL_Texture *mFramebuffer = nullptr;
+    Rasterizer mRasterizer;
+    bool mBrickLayerDirty = true;
+    std::uint64_t mBrickLayerGeneration = 0;
+    std::size_t mBrickLayerDestroyed = 0;
     SDL_GameController *mGameController = nullptr;
-    std::map<std::uint8_t, std::uint8_t> mGameControllerButtons;
-    std::map<std::int32_t, std::int32_t> mKeyboardKeys;
-    bool mRunning = true;
-    bool mPaused = false;
-    bool mGameOver = false;
-    entt::registry mRegistry;
+    bool mProfilerOverlay = false;
+    Profiler::Clock::time_point mNextFrame;
+
+    // Simulation thread.
+    std::bitset<SDL_CONTROLLER_BUTTON_MAX> mGameControllerButtons;
+    std::bitset<SDL_NUM_SCANCODES> mKeyboardKeys;
+    bool mGameControllerConnected = false;
+    std::uint64_t mBrickGeneration = 0;
+    std::vector<Snapshot::Shape> mBricks;
+    std::vector<SDL_Rect> mDestroyedBricks;
+    // Balls then paddles as they were before the last step, in view order.
+    std::vector<std::pair<entt::entity, glm::vec2>> mPreviousPositions;
+    Level::File mLevel;
+    Simulation mSimulation;
+    std::optional<Replay::Recorder> mRecorder;
+    ParticleSystem mParticles{ParticleSystem::Config{}};
+    // Helps integrate large particle counts; null when the machine has no
+    // cores to spare beyond the render and simulation threads.
+    std::unique_ptr<ThreadPool> mParticleThreads;
+
+    // Shared.
+    Options mOptions;
+    Profiler mProfiler;
+    std::atomic<bool> mRunning = true;
+    std::atomic<bool> mPaused = false;
+    // Set by F3 for the simulation thread, which owns the registry.
+    std::atomic<bool> mMemoryReportRequested = false;
+    // Longest rumble requested by the simulation since the render thread last played one.
+    std::atomic<std::uint32_t> mRumbleDuration = 0;
+    SpscQueue<InputEvent, 256> mInputQueue;
+    TripleBuffer<Snapshot> mSnapshots;
+    std::thread mSimulationThread;
 };
\ No newline at end of file
@@ -0,0 +1,329 @@
+#include "CommandLine.hpp"
+#include "Replay.hpp"
+#include "Simulation.hpp"
+#include "ThreadPool.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+    enum class Policy { Idle, Random, Track };
+    enum class Outcome { Cleared, Lost, Timeout };
+
+    struct Options {
+        std::size_t games = 1000;
+        std::size_t threads = std::thread::hardware_concurrency();
+        std::uint64_t maxSteps = 240 * 60 * 5;
+        std::uint32_t seed = 1;
+        float tickRate = 240.0f;
+        Policy policy = Policy::Random;
+        Simulation::Config config;
+        std::string levelPath;
+        std::string recordDirectory;
+        bool endless = false;
+        bool quiet = false;
+        bool memoryReport = false;
+    };
+
+    struct Result {
+        std::uint32_t seed = 0;
+        Outcome outcome = Outcome::Timeout;
+        std::uint64_t steps = 0;
+        std::uint32_t bricksDestroyed = 0;
+    };
+
+    const char *toString(Outcome outcome) {
+        switch (outcome) {
+            case Outcome::Cleared:
+                return "cleared";
+            case Outcome::Lost:
+                return "lost";
+            default:
+                return "timeout";
+        }
+    }
+
+    // Holds a random direction (or none) for a random number of steps.
+    class RandomPolicy {
+    public:
+        explicit RandomPolicy(std::uint32_t seed) : mRandom(seed) {}
+
+        Simulation::Input operator()(const Simulation &) {
+            if (mHold == 0) {
+                std::uniform_int_distribution<int> direction(0, 2);
+                std::uniform_int_distribution<std::uint32_t> hold(1, 120);
+                const int choice = direction(mRandom);
+                mInput.left = choice == 1;
+                mInput.right = choice == 2;
+                mHold = hold(mRandom);
+            }
+            --mHold;
+            return mInput;
+        }
+
+    private:
+        std::mt19937 mRandom;
+        Simulation::Input mInput;
+        std::uint32_t mHold = 0;
+    };
+
+    // Chases the ball with the paddle, aiming at a per-seed offset from the paddle center.
+    class TrackPolicy {
+    public:
+        explicit TrackPolicy(std::uint32_t seed) {
+            std::mt19937 random(seed);
+            mOffset = std::uniform_real_distribution<float>(-30.0f, 30.0f)(random);
+        }
+
+        Simulation::Input operator()(const Simulation &simulation) const {
+            const entt::registry &registry = simulation.getRegistry();
+            float ballCenter = 0.0f;
+            registry.view<const Component::Ball, const Component::Transform>().each([&](entt::entity, const Component::Transform &transform) {
+                ballCenter = transform.position.x + 0.5f * transform.scale.x;
+            });
+
+            Simulation::Input input;
+            registry.view<const Component::Paddle, const Component::Transform>().each([&](entt::entity, const Component::Transform &transform) {
+                const float target = transform.position.x + 0.5f * transform.scale.x + mOffset;
+                input.left = ballCenter < target - 4.0f;
+                input.right = ballCenter > target + 4.0f;
+            });
+            return input;
+        }
+
+    private:
+        float mOffset = 0.0f;
+    };
+
+    template<typename InputPolicy>
+    Result playGame(const Options &options, const Level::File *level, std::uint32_t seed, InputPolicy policy) {
+        Simulation simulation(options.config, level);
+        simulation.reset();
+
+        std::optional<Replay::Recorder> recorder;
+        if (!options.recordDirectory.empty()) {
+            recorder.emplace(options.config, options.tickRate, 0);
+            if (level) {
+                recorder->setLevel(*level);
+            }
+        }
+
+        const float fixedDeltaTime = 1.0f / options.tickRate;
+        Result result{seed, Outcome::Timeout, 0, 0};
+        while (simulation.getSteps() < options.maxSteps) {
+            const Simulation::Input input = policy(simulation);
+            if (recorder) {
+                recorder->record(input);
+            }
+            simulation.fixedUpdate(fixedDeltaTime, input);
+            if (recorder && recorder->isCheckpointDue()) {
+                recorder->checkpoint(simulation.getStateHash());
+            }
+            if (options.endless) {
+                continue;
+            }
+            if (simulation.isCleared()) {
+                result.outcome = Outcome::Cleared;
+                break;
+            }
+            if (simulation.isGameOver()) {
+                result.outcome = Outcome::Lost;
+                break;
+            }
+        }
+        result.steps = simulation.getSteps();
+        result.bricksDestroyed = simulation.getBricksDestroyed();
+
+        if (recorder) {
+            const std::filesystem::path path = std::filesystem::path(options.recordDirectory) / ("game-" + std::to_string(seed) + ".replay");
+            if (!recorder->save(path.string())) {
+                std::fprintf(stderr, "Failed to write %s\n", path.string().c_str());
+            }
+        }
+        return result;
+    }
+
+    Result playGame(const Options &options, const Level::File *level, std::uint32_t seed) {
+        switch (options.policy) {
+            case Policy::Random:
+                return playGame(options, level, seed, RandomPolicy(seed));
+            case Policy::Track:
+                return playGame(options, level, seed, TrackPolicy(seed));
+            default:
+                return playGame(options, level, seed, [](const Simulation &) { return Simulation::Input{}; });
+        }
+    }
+
+    // Memory held by one freshly reset game, which every game starts from.
+    void printMemoryReport(const Options &options, const Level::File *level) {
+        Simulation simulation(options.config, level);
+        simulation.reset();
+        std::size_t total = 0;
+        std::fprintf(stderr, "%-32s %10s %10s %12s\n", "storage", "size", "capacity", "bytes");
+        for (const Simulation::StorageUsage &usage: simulation.getStorageUsage()) {
+            std::fprintf(stderr, "%-32.*s %10zu %10zu %12zu\n", static_cast<int>(usage.name.size()), usage.name.data(), usage.size, usage.capacity, usage.bytes);
+            total += usage.bytes;
+        }
+        const BrickField &brickField = simulation.getBrickField();
+        std::fprintf(stderr, "%-32s %10zu %10u %12zu\n", "BrickField", brickField.getAliveCount(), brickField.getCellCount(), brickField.getByteSize());
+        total += brickField.getByteSize();
+        std::fprintf(stderr, "%-32s %10s %10s %12zu\n", "total", "", "", total);
+    }
+
+    void printUsage(const char *program) {
+        std::fprintf(stderr,
+                     "Usage: %s [options]\n"
+                     "  --games N        number of games to play (default 1000)\n"
+                     "  --threads N      worker threads (default: all cores)\n"
+                     "  --max-steps N    step limit per game (default 72000)\n"
+                     "  --seed N         seed of the first game (default 1)\n"
+                     "  --tick-rate HZ   fixed update rate (default 240)\n"
+                     "  --policy P       idle, random or track (default random)\n"
+                     "  --balls N        balls per game (default 1)\n"
+                     "  --brick-rows N   rows of bricks (default 8)\n"
+                     "  --brick-columns N columns of bricks (default 10)\n"
+                     "  --brick-size WxH brick size in pixels (default 80x20)\n"
+                     "  --level FILE     play a binary level instead of the brick options\n"
+                     "  --ball-velocity XxY launch velocity in pixels/s (default 200x200)\n"
+                     "  --dense-bricks   keep bricks in a bitset grid instead of entities\n"
+                     "  --multi-ball     balls bounce off each other; the game ends with the last one\n"
+                     "  --endless        ignore game over and always play --max-steps\n"
+                     "  --memory-report  print the memory of each component storage for one game\n"
+                     "  --record DIR     write every game to DIR/game-<seed>.replay\n"
+                     "  --quiet          only print the summary\n",
+                     program);
+    }
+
+    bool parseOptions(int argc, char **argv, Options &options) {
+        for (int index = 1; index < argc; ++index) {
+            const std::string_view argument = argv[index];
+            const char *value = index + 1 < argc ? argv[index + 1] : nullptr;
+            if (argument == "--quiet") {
+                options.quiet = true;
+                continue;
+            }
+            if (argument == "--endless") {
+                options.endless = true;
+                continue;
+            }
+            if (argument == "--dense-bricks") {
+                options.config.denseBricks = true;
+                continue;
+            }
+            if (argument == "--multi-ball") {
+                options.config.multiBall = true;
+                continue;
+            }
+            if (argument == "--memory-report") {
+                options.memoryReport = true;
+                continue;
+            }
+            if (!value) {
+                return false;
+            }
+            ++index;
+            if (argument == "--games") {
+                options.games = std::strtoull(value, nullptr, 10);
+            } else if (argument == "--threads") {
+                options.threads = std::strtoull(value, nullptr, 10);
+            } else if (argument == "--max-steps") {
+                options.maxSteps = std::strtoull(value, nullptr, 10);
+            } else if (argument == "--seed") {
+                options.seed = static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10));
+            } else if (argument == "--tick-rate") {
+                options.tickRate = std::strtof(value, nullptr);
+            } else if (argument == "--balls") {
+                options.config.balls = static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10));
+            } else if (argument == "--brick-rows") {
+                options.config.brickRows = static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10));
+            } else if (argument == "--brick-columns") {
+                options.config.brickColumns = static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10));
+            } else if (argument == "--brick-size") {
+                if (!CommandLine::parseVector(value, options.config.brickSize)) {
+                    return false;
+                }
+            } else if (argument == "--ball-velocity") {
+                if (!CommandLine::parseVector(value, options.config.ballVelocity)) {
+                    return false;
+                }
+            } else if (argument == "--level") {
+                options.levelPath = value;
+            } else if (argument == "--record") {
+                options.recordDirectory = value;
+            } else if (argument == "--policy") {
+                const std::string_view policy = value;
+                if (policy == "idle") {
+                    options.policy = Policy::Idle;
+                } else if (policy == "random") {
+                    options.policy = Policy::Random;
+                } else if (policy == "track") {
+                    options.policy = Policy::Track;
+                } else {
+                    return false;
+                }
+            } else {
+                return false;
+            }
+        }
+        return options.tickRate > 0.0f && options.config.brickSize.x > 0.0f && options.config.brickSize.y > 0.0f;
+    }
+}// namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (!options.recordDirectory.empty()) {
+        std::filesystem::create_directories(options.recordDirectory);
+    }
+
+    // Opened once and shared read-only by every game.
+    Level::File level;
+    if (!options.levelPath.empty() && !level.open(options.levelPath)) {
+        std::fprintf(stderr, "Failed to open level %s\n", options.levelPath.c_str());
+        return EXIT_FAILURE;
+    }
+
+    if (options.memoryReport) {
+        printMemoryReport(options, level.isOpen() ? &level : nullptr);
+    }
+
+    std::vector<Result> results(options.games);
+    ThreadPool threadPool(options.threads);
+
+    const auto start = std::chrono::steady_clock::now();
+    threadPool.parallelFor(options.games, 1, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t game = begin; game < end; ++game) {
+            results[game] = playGame(options, level.isOpen() ? &level : nullptr, options.seed + static_cast<std::uint32_t>(game));
+        }
+    });
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::uint64_t totalSteps = 0;
+    std::size_t outcomes[3] = {};
+    if (!options.quiet) {
+        std::printf("seed,outcome,steps,bricks_destroyed\n");
+    }
+    for (const Result &result: results) {
+        totalSteps += result.steps;
+        ++outcomes[static_cast<std::size_t>(result.outcome)];
+        if (!options.quiet) {
+            std::printf("%u,%s,%llu,%u\n", result.seed, toString(result.outcome), static_cast<unsigned long long>(result.steps), result.bricksDestroyed);
+        }
+    }
+
+    std::fprintf(stderr, "games: %zu (cleared %zu, lost %zu, timeout %zu)\n", options.games, outcomes[0], outcomes[1], outcomes[2]);
+    std::fprintf(stderr, "threads: %zu\n", threadPool.getThreadCount());
+    std::fprintf(stderr, "steps: %llu in %.3f s (%.0f steps/s)\n", static_cast<unsigned long long>(totalSteps), elapsed.count(), static_cast<double>(totalSteps) / elapsed.count());
+    return EXIT_SUCCESS;
+}
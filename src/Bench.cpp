@@ -0,0 +1,452 @@
+#include "Collision.hpp"
+#include "CommandLine.hpp"
+#include "ParticleSystem.hpp"
+#include "Rasterizer.hpp"
+#include "RenderBatch.hpp"
+#include "Scene.hpp"
+#include "Simulation.hpp"
+#include "ThreadPool.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+    struct Options {
+        Simulation::Config config;
+        std::uint32_t walls = 0;
+        std::size_t boxes = 4096;
+        float tickRate = 240.0f;
+        double minTime = 0.5;
+        std::string filter;
+        std::string levelPath;
+    };
+
+    // One benchmark run. A batch performs operationsPerIteration operations on
+    // entities entities per iteration; prepare runs untimed before every batch.
+    struct Kernel {
+        const char *name;
+        std::size_t entities;
+        std::uint64_t operationsPerIteration;
+        std::function<void(std::uint64_t iterations)> run;
+        std::function<void()> prepare;
+    };
+
+    // Keeps results observable so the compiler cannot drop the measured work.
+    volatile std::uint64_t sink = 0;
+
+    void measure(const Options &options, const Kernel &kernel) {
+        if (!options.filter.empty() && std::string_view(kernel.name).find(options.filter) == std::string_view::npos) {
+            return;
+        }
+
+        const auto runBatch = [&kernel](std::uint64_t iterations) {
+            if (kernel.prepare) {
+                kernel.prepare();
+            }
+            const auto start = std::chrono::steady_clock::now();
+            kernel.run(iterations);
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        };
+
+        // Warm up caches and grow the batch until it takes about 10 ms, then
+        // repeat batches until the minimum time is spent.
+        std::uint64_t batch = 1;
+        while (runBatch(batch) < 0.01 && batch < (1u << 30)) {
+            batch *= 2;
+        }
+
+        std::uint64_t iterations = 0;
+        double seconds = 0.0;
+        while (seconds < options.minTime) {
+            seconds += runBatch(batch);
+            iterations += batch;
+        }
+
+        const double operations = static_cast<double>(iterations * kernel.operationsPerIteration);
+        std::printf("%s,%zu,%llu,%.6f,%.2f,%.0f\n", kernel.name, kernel.entities, static_cast<unsigned long long>(iterations * kernel.operationsPerIteration), seconds, seconds * 1e9 / operations, static_cast<double>(kernel.entities) * static_cast<double>(iterations) / seconds);
+    }
+
+    // Extra walls far outside the field: never hit, but swept against by every ball.
+    void addWalls(Simulation &simulation, std::uint32_t walls) {
+        entt::registry &registry = simulation.getRegistry();
+        for (std::uint32_t wall = 0; wall < walls; ++wall) {
+            const entt::entity entity = registry.create();
+            registry.emplace<Component::Wall>(entity);
+            registry.emplace<Component::Transform>(entity, glm::vec2(-1000.0f - 30.0f * static_cast<float>(wall), 0.0f), glm::vec2(20.0f, 20.0f));
+        }
+    }
+
+    // Restarts the game whenever the measured steps have finished it.
+    void keepPlaying(Simulation &simulation, std::uint32_t walls) {
+        if (simulation.isGameOver() || simulation.isCleared()) {
+            simulation.reset();
+            addWalls(simulation, walls);
+        }
+    }
+
+    std::size_t countEntities(const Simulation &simulation) {
+        return simulation.getRegistry().view<const Component::Transform>().size() + simulation.getBrickField().getAliveCount();
+    }
+
+    SDL_Rect toRect(const Component::Transform &transform) {
+        return SDL_Rect{static_cast<int>(transform.position.x), static_cast<int>(transform.position.y), static_cast<int>(transform.scale.x), static_cast<int>(transform.scale.y)};
+    }
+
+    SDL_Color toColor(const Component::Color &color) {
+        return SDL_Color{color.r, color.g, color.b, color.a};
+    }
+
+    // Builds the same geometry as Application::render() with the brick layer disabled.
+    void drawWorld(const Simulation &simulation, RenderBatch &renderBatch) {
+        const entt::registry &registry = simulation.getRegistry();
+        const BrickField &brickField = simulation.getBrickField();
+        renderBatch.clear();
+        registry.view<const Component::Goal, const Component::Transform>().each([&](entt::entity, const Component::Transform &transform) {
+            renderBatch.fillRect(toRect(transform), SDL_Color{0, 0, 0, 255});
+        });
+        registry.view<const Component::Wall, const Component::Transform>().each([&](entt::entity, const Component::Transform &transform) {
+            renderBatch.fillRect(toRect(transform), SDL_Color{0, 0, 0, 255});
+        });
+        registry.view<const Component::Transform, const Component::Sprite>().each([&](entt::entity, const Component::Transform &transform, const Component::Sprite &sprite) {
+            renderBatch.fillRect(toRect(transform), toColor(sprite.color));
+            renderBatch.drawRect(toRect(transform), toColor(Scene::getOutlineColor(sprite.color)));
+        });
+        brickField.forEachAlive([&](std::uint32_t cell) {
+            const SDL_Rect rect = toRect(brickField.getTransform(cell));
+            const Component::Color fill = brickField.getColor(cell);
+            renderBatch.fillRect(rect, toColor(fill));
+            renderBatch.drawRect(rect, toColor(Scene::getOutlineColor(fill)));
+        });
+    }
+
+    void benchmarkCollision(const Options &options) {
+        std::mt19937 random(1);
+        std::uniform_real_distribution<float> position(0.0f, 800.0f);
+        std::uniform_real_distribution<float> size(5.0f, 80.0f);
+        std::vector<Component::Transform> boxes(options.boxes);
+        for (Component::Transform &box: boxes) {
+            box = Component::Transform{glm::vec2(position(random), position(random)), glm::vec2(size(random), size(random))};
+        }
+        const Component::Transform ball{glm::vec2(400.0f, 400.0f), glm::vec2(10.0f, 10.0f)};
+        const glm::vec2 displacement = options.config.ballVelocity / options.tickRate;
+
+        measure(options, Kernel{"collision.overlaps", boxes.size(), boxes.size(), [&](std::uint64_t iterations) {
+                                    std::uint64_t hits = 0;
+                                    for (std::uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                                        for (const Component::Transform &box: boxes) {
+                                            hits += Collision::overlaps(ball, box);
+                                        }
+                                    }
+                                    sink = sink + hits;
+                                }, nullptr});
+
+        measure(options, Kernel{"collision.sweep", boxes.size(), boxes.size(), [&](std::uint64_t iterations) {
+                                    std::uint64_t hits = 0;
+                                    for (std::uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                                        for (const Component::Transform &box: boxes) {
+                                            hits += Collision::sweep(ball, displacement, box).has_value();
+                                        }
+                                    }
+                                    sink = sink + hits;
+                                }, nullptr});
+
+        Collision::Boxes batch;
+        for (const Component::Transform &box: boxes) {
+            batch.add(box);
+        }
+        const char *names[] = {"collision.sweepBatch.scalar", "collision.sweepBatch.sse2", "collision.sweepBatch.avx2"};
+        for (int instructionSet = 0; instructionSet <= static_cast<int>(Collision::getInstructionSet()); ++instructionSet) {
+            measure(options, Kernel{names[instructionSet], boxes.size(), boxes.size(), [&](std::uint64_t iterations) {
+                                        std::uint64_t hits = 0;
+                                        for (std::uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                                            hits += Collision::sweep(ball, displacement, batch, static_cast<Collision::InstructionSet>(instructionSet)).has_value();
+                                        }
+                                        sink = sink + hits;
+                                    }, nullptr});
+        }
+    }
+
+    void benchmarkLevel(const Options &options, const Level::File *level) {
+        if (level) {
+            Level::File file;
+            measure(options, Kernel{"level.open", level->getBrickCount(), 1, [&](std::uint64_t iterations) {
+                                        for (std::uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                                            file.open(options.levelPath);
+                                        }
+                                    }, nullptr});
+        }
+
+        Simulation simulation(options.config, level);
+        simulation.reset();
+        measure(options, Kernel{"level.reset", countEntities(simulation), 1, [&](std::uint64_t iterations) {
+                                    for (std::uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                                        simulation.reset();
+                                    }
+                                }, nullptr});
+    }
+
+    void benchmarkSimulation(const Options &options, const Level::File *level) {
+        const float fixedDeltaTime = 1.0f / options.tickRate;
+        Simulation simulation(options.config, level);
+        simulation.reset();
+        addWalls(simulation, options.walls);
+        const std::size_t entities = countEntities(simulation);
+        const auto prepare = [&] { keepPlaying(simulation, options.walls); };
+
+        measure(options, Kernel{"simulation.updatePositions", entities, 1, [&](std::uint64_t iterations) {
+                                    Simulation::Input input;
+                                    for (std::uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                                        // Sweep the paddle back and forth so both branches run.
+                                        input.left = (iteration / 256) % 2 == 0;
+                                        input.right = !input.left;
+                                        simulation.updatePositions(fixedDeltaTime, input);
+                                    }
+                                }, prepare});
+
+        measure(options, Kernel{"simulation.checkCollisions", entities, 1, [&](std::uint64_t iterations) {
+                                    for (std::uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                                        simulation.checkCollisions(fixedDeltaTime);
+                                    }
+                                }, prepare});
+
+        if (options.config.multiBall) {
+            measure(options, Kernel{"simulation.resolveBallCollisions", simulation.getBallCount(), 1, [&](std::uint64_t iterations) {
+                                        for (std::uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                                            simulation.resolveBallCollisions();
+                                        }
+                                    }, prepare});
+        }
+
+        measure(options, Kernel{"simulation.fixedUpdate", entities, 1, [&](std::uint64_t iterations) {
+                                    for (std::uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                                        simulation.fixedUpdate(fixedDeltaTime, Simulation::Input{});
+                                    }
+                                }, prepare});
+
+        keepPlaying(simulation, options.walls);
+        std::vector<std::uint8_t> state;
+        simulation.saveState(state);
+        measure(options, Kernel{"state.save", entities, 1, [&](std::uint64_t iterations) {
+                                    std::vector<std::uint8_t> bytes;
+                                    for (std::uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                                        simulation.saveState(bytes);
+                                    }
+                                    sink = sink + bytes.size();
+                                }, nullptr});
+
+        measure(options, Kernel{"state.load", entities, 1, [&](std::uint64_t iterations) {
+                                    for (std::uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                                        simulation.loadState(state.data(), state.size());
+                                    }
+                                }, nullptr});
+
+        // A rollback as Rollback::synchronize() does it: load the oldest state,
+        // then save and run every tick again.
+        measure(options, Kernel{"simulation.rollback8", entities, 1, [&](std::uint64_t iterations) {
+                                    std::vector<std::uint8_t> bytes;
+                                    for (std::uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                                        simulation.loadState(state.data(), state.size());
+                                        for (int tick = 0; tick < 8; ++tick) {
+                                            simulation.saveState(bytes);
+                                            simulation.fixedUpdate(fixedDeltaTime, Simulation::Input{});
+                                            simulation.update();
+                                        }
+                                    }
+                                }, nullptr});
+    }
+
+    void benchmarkRender(const Options &options, const Level::File *level) {
+        Simulation simulation(options.config, level);
+        simulation.reset();
+        addWalls(simulation, options.walls);
+        const std::size_t entities = countEntities(simulation);
+
+        RenderBatch renderBatch;
+        measure(options, Kernel{"render.batch", entities, 1, [&](std::uint64_t iterations) {
+                                    for (std::uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                                        drawWorld(simulation, renderBatch);
+                                    }
+                                    sink = sink + renderBatch.getQuadCount();
+                                }, nullptr});
+
+        std::vector<std::uint8_t> pixels(static_cast<std::size_t>(Scene::width) * Scene::height * 4);
+        const char *names[] = {"render.rasterizer.scalar", "render.rasterizer.sse2", "render.rasterizer.avx2"};
+        for (int instructionSet = 0; instructionSet <= static_cast<int>(Collision::getInstructionSet()); ++instructionSet) {
+            Rasterizer rasterizer(static_cast<Collision::InstructionSet>(instructionSet));
+            rasterizer.setTarget(pixels.data(), Scene::width, Scene::height, Scene::width * 4, Rasterizer::Format::RGBA8);
+            measure(options, Kernel{names[instructionSet], entities, 1, [&](std::uint64_t iterations) {
+                                        for (std::uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                                            Scene::rasterize(simulation, rasterizer);
+                                        }
+                                        sink = sink + pixels[0];
+                                    }, nullptr});
+        }
+
+        // Rasterizes the batch with SDL's software renderer, so no window or GPU is needed.
+        SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, 800, 600, 32, SDL_PIXELFORMAT_RGBA8888);
+        SDL_Renderer *renderer = surface ? SDL_CreateSoftwareRenderer(surface) : nullptr;
+        if (!renderer) {
+            std::fprintf(stderr, "Skipping render.software: %s\n", SDL_GetError());
+            SDL_FreeSurface(surface);
+            return;
+        }
+        measure(options, Kernel{"render.software", entities, 1, [&](std::uint64_t iterations) {
+                                    for (std::uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                                        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+                                        SDL_RenderClear(renderer);
+                                        drawWorld(simulation, renderBatch);
+                                        renderBatch.submit(renderer);
+                                    }
+                                }, nullptr});
+        SDL_DestroyRenderer(renderer);
+        SDL_FreeSurface(surface);
+    }
+
+    void benchmarkParticles(const Options &options) {
+        // A full pool of debris, integrated with a tiny step so none of it
+        // expires mid-measurement; the cost does not depend on the step.
+        const auto fill = [](ParticleSystem &particles) {
+            particles.clear();
+            while (particles.size() < particles.capacity()) {
+                particles.emit(glm::vec2(0.0f, 0.0f), glm::vec2(800.0f, 600.0f), 0xFF00FFFFu, 1000);
+            }
+        };
+        const float deltaTime = 1e-6f;
+        ParticleSystem::Config config;
+        const char *names[] = {"particles.update.scalar", "particles.update.sse2", "particles.update.avx2"};
+        for (int instructionSet = 0; instructionSet <= static_cast<int>(Collision::getInstructionSet()); ++instructionSet) {
+            ParticleSystem particles(config, static_cast<Collision::InstructionSet>(instructionSet));
+            measure(options, Kernel{names[instructionSet], config.capacity, 1, [&](std::uint64_t iterations) {
+                                        for (std::uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                                            particles.update(deltaTime);
+                                        }
+                                        sink = sink + particles.size();
+                                    }, [&] { fill(particles); }});
+        }
+
+        ParticleSystem particles(config);
+        ThreadPool threadPool;
+        measure(options, Kernel{"particles.update.threads", config.capacity, 1, [&](std::uint64_t iterations) {
+                                    for (std::uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                                        particles.update(deltaTime, &threadPool);
+                                    }
+                                    sink = sink + particles.size();
+                                }, [&] { fill(particles); }});
+
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<std::uint32_t> colors;
+        fill(particles);
+        measure(options, Kernel{"particles.snapshot", config.capacity, 1, [&](std::uint64_t iterations) {
+                                    for (std::uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                                        particles.copyTo(x, y, colors);
+                                    }
+                                    sink = sink + colors.size();
+                                }, nullptr});
+
+        RenderBatch renderBatch;
+        measure(options, Kernel{"particles.batch", config.capacity, 1, [&](std::uint64_t iterations) {
+                                    for (std::uint64_t iteration = 0; iteration < iterations; ++iteration) {
+                                        renderBatch.clear();
+                                        renderBatch.fillSquares(x.data(), y.data(), colors.data(), colors.size(), 3.0f);
+                                    }
+                                    sink = sink + renderBatch.getQuadCount();
+                                }, nullptr});
+    }
+
+    void printUsage(const char *program) {
+        std::fprintf(stderr,
+                     "Usage: %s [options]\n"
+                     "  --filter TEXT     only run kernels whose name contains TEXT\n"
+                     "  --min-time SEC    minimum measured time per kernel (default 0.5)\n"
+                     "  --boxes N         boxes tested by the collision kernels (default 4096)\n"
+                     "  --tick-rate HZ    fixed update rate (default 240)\n"
+                     "  --balls N         balls in the simulation (default 1)\n"
+                     "  --walls N         extra walls outside the field (default 0)\n"
+                     "  --brick-rows N    rows of bricks (default 8)\n"
+                     "  --brick-columns N columns of bricks (default 10)\n"
+                     "  --brick-size WxH  brick size in pixels (default 80x20)\n"
+                     "  --dense-bricks    keep bricks in a bitset grid instead of entities\n"
+                     "  --multi-ball      balls bounce off each other (adds simulation.resolveBallCollisions)\n"
+                     "  --level FILE      use a binary level instead of the brick options\n"
+                     "  --ball-velocity XxY launch velocity in pixels/s (default 200x200)\n",
+                     program);
+    }
+
+    bool parseOptions(int argc, char **argv, Options &options) {
+        for (int index = 1; index < argc; ++index) {
+            const std::string_view argument = argv[index];
+            if (argument == "--dense-bricks") {
+                options.config.denseBricks = true;
+                continue;
+            }
+            if (argument == "--multi-ball") {
+                options.config.multiBall = true;
+                continue;
+            }
+            if (index + 1 == argc) {
+                return false;
+            }
+            const char *value = argv[++index];
+            if (argument == "--filter") {
+                options.filter = value;
+            } else if (argument == "--level") {
+                options.levelPath = value;
+            } else if (argument == "--min-time") {
+                options.minTime = std::strtod(value, nullptr);
+            } else if (argument == "--boxes") {
+                options.boxes = std::strtoull(value, nullptr, 10);
+            } else if (argument == "--tick-rate") {
+                options.tickRate = std::strtof(value, nullptr);
+            } else if (argument == "--balls") {
+                options.config.balls = static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10));
+            } else if (argument == "--walls") {
+                options.walls = static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10));
+            } else if (argument == "--brick-rows") {
+                options.config.brickRows = static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10));
+            } else if (argument == "--brick-columns") {
+                options.config.brickColumns = static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10));
+            } else if (argument == "--brick-size") {
+                if (!CommandLine::parseVector(value, options.config.brickSize)) {
+                    return false;
+                }
+            } else if (argument == "--ball-velocity") {
+                if (!CommandLine::parseVector(value, options.config.ballVelocity)) {
+                    return false;
+                }
+            } else {
+                return false;
+            }
+        }
+        return options.tickRate > 0.0f && options.config.brickSize.x > 0.0f && options.config.brickSize.y > 0.0f;
+    }
+}// namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    Level::File level;
+    if (!options.levelPath.empty() && !level.open(options.levelPath)) {
+        std::fprintf(stderr, "Failed to open level %s\n", options.levelPath.c_str());
+        return EXIT_FAILURE;
+    }
+    const Level::File *levelPointer = level.isOpen() ? &level : nullptr;
+
+    std::printf("kernel,entities,operations,seconds,ns_per_op,entities_per_sec\n");
+    benchmarkCollision(options);
+    benchmarkLevel(options, levelPointer);
+    benchmarkSimulation(options, levelPointer);
+    benchmarkRender(options, levelPointer);
+    benchmarkParticles(options);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,125 @@
+#include "BreakoutEnv.h"
+
+#include "Level.hpp"
+#include "VectorEnv.hpp"
+
+#include <exception>
+#include <memory>
+#include <optional>
+#include <thread>
+
+struct BreakoutEnv {
+    // Opened before the games that play it.
+    Level::File level;
+    std::optional<VectorEnv> vectorEnv;
+};
+
+namespace {
+    VectorEnv::Config toConfig(const BreakoutEnvConfig &config) {
+        VectorEnv::Config result;
+        result.envCount = config.envCount;
+        result.threads = config.threads == 0 ? std::thread::hardware_concurrency() : config.threads;
+        result.ticksPerStep = config.ticksPerStep;
+        result.tickRate = config.tickRate;
+        result.maxSteps = config.maxSteps;
+        result.simulation.balls = config.balls;
+        result.simulation.brickRows = config.brickRows;
+        result.simulation.brickColumns = config.brickColumns;
+        result.simulation.brickSize = glm::vec2(config.brickSize[0], config.brickSize[1]);
+        result.simulation.ballVelocity = glm::vec2(config.ballVelocity[0], config.ballVelocity[1]);
+        result.simulation.denseBricks = config.denseBricks != 0;
+        result.simulation.multiBall = config.multiBall != 0;
+        return result;
+    }
+}// namespace
+
+extern "C" {
+void breakout_env_default_config(BreakoutEnvConfig *config) {
+    const VectorEnv::Config defaults;
+    *config = BreakoutEnvConfig{};
+    config->envCount = static_cast<uint32_t>(defaults.envCount);
+    config->threads = 0;
+    config->ticksPerStep = defaults.ticksPerStep;
+    config->tickRate = defaults.tickRate;
+    config->maxSteps = static_cast<uint32_t>(defaults.maxSteps);
+    config->balls = defaults.simulation.balls;
+    config->brickRows = defaults.simulation.brickRows;
+    config->brickColumns = defaults.simulation.brickColumns;
+    config->brickSize[0] = defaults.simulation.brickSize.x;
+    config->brickSize[1] = defaults.simulation.brickSize.y;
+    config->ballVelocity[0] = defaults.simulation.ballVelocity.x;
+    config->ballVelocity[1] = defaults.simulation.ballVelocity.y;
+    config->denseBricks = defaults.simulation.denseBricks;
+    config->multiBall = defaults.simulation.multiBall;
+    config->levelPath = nullptr;
+}
+
+BreakoutEnv *breakout_env_create(const BreakoutEnvConfig *config) {
+    if (!config || config->envCount == 0 || !(config->tickRate > 0.0f) || config->balls == 0 || !(config->brickSize[0] > 0.0f) || !(config->brickSize[1] > 0.0f)) {
+        return nullptr;
+    }
+    // Nothing may throw across the C boundary.
+    try {
+        auto env = std::make_unique<BreakoutEnv>();
+        if (config->levelPath && !env->level.open(config->levelPath)) {
+            return nullptr;
+        }
+        env->vectorEnv.emplace(toConfig(*config), env->level.isOpen() ? &env->level : nullptr);
+        return env.release();
+    } catch (const std::exception &) {
+        return nullptr;
+    }
+}
+
+void breakout_env_destroy(BreakoutEnv *env) {
+    delete env;
+}
+
+uint32_t breakout_env_count(const BreakoutEnv *env) {
+    return static_cast<uint32_t>(env->vectorEnv->getEnvCount());
+}
+
+uint32_t breakout_env_thread_count(const BreakoutEnv *env) {
+    return static_cast<uint32_t>(env->vectorEnv->getThreadCount());
+}
+
+uint32_t breakout_env_observation_size(const BreakoutEnv *env) {
+    return static_cast<uint32_t>(env->vectorEnv->getObservationSize());
+}
+
+uint32_t breakout_env_brick_columns(const BreakoutEnv *env) {
+    return env->vectorEnv->getBrickColumns();
+}
+
+uint32_t breakout_env_brick_rows(const BreakoutEnv *env) {
+    return env->vectorEnv->getBrickRows();
+}
+
+void breakout_env_set_buffers(BreakoutEnv *env, float *observations, float *rewards, uint8_t *dones) {
+    env->vectorEnv->setBuffers(observations, rewards, dones);
+}
+
+int breakout_env_reset(BreakoutEnv *env) {
+    if (!env->vectorEnv->hasBuffers()) {
+        return -1;
+    }
+    env->vectorEnv->reset();
+    return 0;
+}
+
+int breakout_env_step(BreakoutEnv *env, const uint8_t *actions) {
+    if (!env->vectorEnv->hasBuffers() || !actions) {
+        return -1;
+    }
+    env->vectorEnv->step(actions);
+    return 0;
+}
+
+int breakout_env_render(BreakoutEnv *env, uint8_t *frames, uint32_t width, uint32_t height, uint32_t channels) {
+    if (!frames || width == 0 || height == 0 || width > 16384 || height > 16384 || (channels != 1 && channels != 4)) {
+        return -1;
+    }
+    env->vectorEnv->render(frames, static_cast<int>(width), static_cast<int>(height), channels == 4 ? Rasterizer::Format::RGBA8 : Rasterizer::Format::Gray8);
+    return 0;
+}
+}
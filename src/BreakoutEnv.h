@@ -0,0 +1,113 @@
+#ifndef BREAKOUT_ENV_H
+#define BREAKOUT_ENV_H
+
+/*
+ * C API of the BreakoutEnv library: a batch of headless Breakout games stepped
+ * together, for training code. Observations, rewards and done flags are
+ * written straight into buffers owned by the caller, so stepping neither
+ * allocates nor copies. Games are independent and step in parallel.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32) && defined(BREAKOUT_ENV_SHARED)
+#ifdef BREAKOUT_ENV_BUILD
+#define BREAKOUT_ENV_API __declspec(dllexport)
+#else
+#define BREAKOUT_ENV_API __declspec(dllimport)
+#endif
+#elif defined(BREAKOUT_ENV_BUILD)
+#define BREAKOUT_ENV_API __attribute__((visibility("default")))
+#else
+#define BREAKOUT_ENV_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct BreakoutEnv BreakoutEnv;
+
+/* Paddle action of one game for one step. */
+enum {
+    BREAKOUT_ACTION_STAY = 0,
+    BREAKOUT_ACTION_LEFT = 1,
+    BREAKOUT_ACTION_RIGHT = 2
+};
+
+typedef struct BreakoutEnvConfig {
+    uint32_t envCount;
+    /* Worker threads; 0 uses every core, 1 steps on the calling thread. */
+    uint32_t threads;
+    /* Fixed updates run per step with the same action. */
+    uint32_t ticksPerStep;
+    float tickRate;
+    /* Steps after which a game is cut short and reported done; 0 never. */
+    uint32_t maxSteps;
+    uint32_t balls;
+    uint32_t brickRows;
+    uint32_t brickColumns;
+    float brickSize[2];
+    float ballVelocity[2];
+    /* Keeps bricks in a bitset grid instead of entities. */
+    uint8_t denseBricks;
+    /* Balls bounce off each other and a lost ball only ends the game when it was the last. */
+    uint8_t multiBall;
+    /* Binary level to play instead of the brick options; may be null. */
+    const char *levelPath;
+} BreakoutEnvConfig;
+
+/* Fills config with the defaults of the batch runner and 16 games. */
+BREAKOUT_ENV_API void breakout_env_default_config(BreakoutEnvConfig *config);
+
+/* Returns null when the config is invalid or the level fails to load. */
+BREAKOUT_ENV_API BreakoutEnv *breakout_env_create(const BreakoutEnvConfig *config);
+BREAKOUT_ENV_API void breakout_env_destroy(BreakoutEnv *env);
+
+BREAKOUT_ENV_API uint32_t breakout_env_count(const BreakoutEnv *env);
+/* Threads stepping the games, the calling thread included. */
+BREAKOUT_ENV_API uint32_t breakout_env_thread_count(const BreakoutEnv *env);
+
+/*
+ * Floats in the observation of one game, laid out as:
+ *   paddle center x, y
+ *   per ball (config balls): center x, y, velocity x, y, 1 if in play else 0
+ *   per brick cell, row by row: remaining hit points, 0 once destroyed
+ * Positions and velocities are in pixels and pixels/s.
+ */
+BREAKOUT_ENV_API uint32_t breakout_env_observation_size(const BreakoutEnv *env);
+BREAKOUT_ENV_API uint32_t breakout_env_brick_columns(const BreakoutEnv *env);
+BREAKOUT_ENV_API uint32_t breakout_env_brick_rows(const BreakoutEnv *env);
+
+/*
+ * Sets where reset and step write: observations holds envCount *
+ * observation_size floats, game after game; rewards and dones hold envCount
+ * entries. The buffers must stay valid until replaced or the env destroyed.
+ */
+BREAKOUT_ENV_API void breakout_env_set_buffers(BreakoutEnv *env, float *observations, float *rewards, uint8_t *dones);
+
+/* Starts every game over and writes their observations. Returns 0, or -1 without buffers. */
+BREAKOUT_ENV_API int breakout_env_reset(BreakoutEnv *env);
+
+/*
+ * Applies actions[envCount] to every game. The reward is +1 per destroyed
+ * brick and -1 per lost ball. A game that ends is reported done and restarted
+ * at once, so its observation is already the first one of the next game.
+ * Returns 0, or -1 without buffers.
+ */
+BREAKOUT_ENV_API int breakout_env_step(BreakoutEnv *env, const uint8_t *actions);
+
+/*
+ * Draws every game as pixels into frames, which holds envCount images of
+ * width x height, game after game, rows top to bottom without padding.
+ * channels is 4 for RGBA bytes or 1 for grayscale. The 800x600 playfield is
+ * stretched over the image. Returns 0, or -1 for an invalid size or channels.
+ */
+BREAKOUT_ENV_API int breakout_env_render(BreakoutEnv *env, uint8_t *frames, uint32_t width, uint32_t height, uint32_t channels);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,92 @@
+#include "BrickField.hpp"
+#include "Level.hpp"
+
+#include <algorithm>
+
+void BrickField::reset(glm::vec2 origin, glm::vec2 cellSize, std::uint32_t columns, std::uint32_t rows) {
+    mOrigin = origin;
+    mCellSize = cellSize;
+    mColumns = columns;
+    mRows = rows;
+    const auto cells = static_cast<std::size_t>(Level::getCellCount(columns, rows));
+    mAliveCount = 0;
+    mAlive.assign((cells + 63) / 64, 0);
+    mColors.assign(cells, 0);
+    mHitPoints.assign(cells, 0);
+}
+
+void BrickField::set(std::uint32_t cell, std::uint8_t color, std::uint8_t hitPoints) {
+    if (isAlive(cell)) {
+        mAlive[cell / 64] &= ~(std::uint64_t{1} << (cell % 64));
+        --mAliveCount;
+    }
+    mColors[cell] = color;
+    mHitPoints[cell] = hitPoints;
+    if (hitPoints > 0) {
+        mAlive[cell / 64] |= std::uint64_t{1} << (cell % 64);
+        ++mAliveCount;
+    }
+}
+
+void BrickField::assign(const std::uint8_t *colors, const std::uint8_t *hitPoints) {
+    const std::size_t cells = mColors.size();
+    std::copy(colors, colors + cells, mColors.begin());
+    std::copy(hitPoints, hitPoints + cells, mHitPoints.begin());
+    updateAlive();
+}
+
+void BrickField::save(std::vector<std::uint8_t> &bytes) const {
+    Serialize::writeArray(bytes, mHitPoints.data(), mHitPoints.size());
+}
+
+bool BrickField::load(Serialize::Reader &reader) {
+    if (!reader.readArray(mHitPoints.data(), mHitPoints.size())) {
+        return false;
+    }
+    updateAlive();
+    return true;
+}
+
+void BrickField::updateAlive() {
+    const std::size_t cells = mHitPoints.size();
+    mAliveCount = 0;
+    for (std::size_t word = 0; word < mAlive.size(); ++word) {
+        const std::size_t first = word * 64;
+        const std::size_t last = std::min(first + 64, cells);
+        std::uint64_t bits = 0;
+        for (std::size_t cell = first; cell < last; ++cell) {
+            bits |= static_cast<std::uint64_t>(mHitPoints[cell] != 0) << (cell - first);
+        }
+        mAlive[word] = bits;
+        mAliveCount += static_cast<std::size_t>(std::popcount(bits));
+    }
+}
+
+bool BrickField::hit(std::uint32_t cell) {
+    if (!isAlive(cell)) {
+        return false;
+    }
+    if (--mHitPoints[cell] > 0) {
+        return false;
+    }
+    mAlive[cell / 64] &= ~(std::uint64_t{1} << (cell % 64));
+    --mAliveCount;
+    return true;
+}
+
+BrickField::CellRange BrickField::getCellRange(glm::vec2 min, glm::vec2 max) const {
+    // Same rule as SpatialGrid: the exclusive upper bound keeps a box that ends
+    // on a cell boundary out of the next cell. Boxes outside the field give an
+    // empty range instead of being clamped onto the border.
+    const glm::vec2 first = glm::max(glm::floor((min - mOrigin) / mCellSize), glm::vec2(0.0f, 0.0f));
+    const glm::vec2 last = glm::min(glm::ceil((max - mOrigin) / mCellSize) - glm::vec2(1.0f, 1.0f), glm::vec2(static_cast<float>(mColumns) - 1.0f, static_cast<float>(mRows) - 1.0f));
+    if (first.x > last.x || first.y > last.y) {
+        return CellRange{0, 0, -1, -1};
+    }
+    return CellRange{static_cast<std::int32_t>(first.x), static_cast<std::int32_t>(first.y), static_cast<std::int32_t>(last.x), static_cast<std::int32_t>(last.y)};
+}
+
+Component::Transform BrickField::getTransform(std::uint32_t cell) const {
+    const glm::vec2 position(static_cast<float>(cell % mColumns) * mCellSize.x, static_cast<float>(cell / mColumns) * mCellSize.y);
+    return Component::Transform{mOrigin + position, mCellSize};
+}
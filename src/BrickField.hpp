@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Component.hpp"
+#include "Serialize.hpp"
+
+#include <glm/glm.hpp>
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Bricks on a regular grid, stored as a bitset of alive cells plus one color
+// (palette index) and one hit points byte per cell: a few bits per brick
+// instead of an entity with components. Cells are numbered row by row.
+class BrickField {
+public:
+    // Inclusive cell bounds; empty when a minimum exceeds its maximum.
+    struct CellRange {
+        std::int32_t minColumn;
+        std::int32_t minRow;
+        std::int32_t maxColumn;
+        std::int32_t maxRow;
+    };
+
+    // Empties the field and resizes it to columns x rows cells of cellSize starting at origin.
+    void reset(glm::vec2 origin, glm::vec2 cellSize, std::uint32_t columns, std::uint32_t rows);
+    void setPalette(std::vector<Component::Color> palette) { mPalette = std::move(palette); }
+
+    void set(std::uint32_t cell, std::uint8_t color, std::uint8_t hitPoints);
+    // Copies getCellCount() colors and hit points, e.g. straight from a level file.
+    void assign(const std::uint8_t *colors, const std::uint8_t *hitPoints);
+    // Takes one hit point and returns true when that destroyed the brick.
+    bool hit(std::uint32_t cell);
+
+    // Hit points of every cell; colors and layout are not saved, so loading
+    // needs a field reset to the same level.
+    void save(std::vector<std::uint8_t> &bytes) const;
+    bool load(Serialize::Reader &reader);
+
+    [[nodiscard]] bool isAlive(std::uint32_t cell) const { return (mAlive[cell / 64] >> (cell % 64)) & 1u; }
+    [[nodiscard]] std::size_t getAliveCount() const { return mAliveCount; }
+    [[nodiscard]] bool empty() const { return mAliveCount == 0; }
+
+    // Cells overlapping the box, found in constant time from its corners.
+    [[nodiscard]] CellRange getCellRange(glm::vec2 min, glm::vec2 max) const;
+
+    [[nodiscard]] Component::Transform getTransform(std::uint32_t cell) const;
+    [[nodiscard]] Component::Color getColor(std::uint32_t cell) const { return mPalette[mColors[cell]]; }
+    [[nodiscard]] std::uint8_t getHitPoints(std::uint32_t cell) const { return mHitPoints[cell]; }
+
+    [[nodiscard]] std::uint32_t getColumns() const { return mColumns; }
+    [[nodiscard]] std::uint32_t getRows() const { return mRows; }
+    [[nodiscard]] std::uint32_t getCellCount() const { return static_cast<std::uint32_t>(mHitPoints.size()); }
+    // Heap bytes held by the per-cell arrays and the palette.
+    [[nodiscard]] std::size_t getByteSize() const {
+        return mAlive.capacity() * sizeof(std::uint64_t) + mColors.capacity() + mHitPoints.capacity() + mPalette.capacity() * sizeof(Component::Color);
+    }
+
+    // Calls function(cell) for every alive brick in cell order.
+    template<typename Function>
+    void forEachAlive(Function &&function) const {
+        for (std::size_t word = 0; word < mAlive.size(); ++word) {
+            for (std::uint64_t bits = mAlive[word]; bits != 0; bits &= bits - 1) {
+                function(static_cast<std::uint32_t>(word * 64 + static_cast<std::size_t>(std::countr_zero(bits))));
+            }
+        }
+    }
+
+private:
+    // Rebuilds the alive bits and count from the hit points.
+    void updateAlive();
+
+    glm::vec2 mOrigin = glm::vec2(0.0f, 0.0f);
+    glm::vec2 mCellSize = glm::vec2(1.0f, 1.0f);
+    std::uint32_t mColumns = 0;
+    std::uint32_t mRows = 0;
+    std::size_t mAliveCount = 0;
+    std::vector<std::uint64_t> mAlive;
+    std::vector<std::uint8_t> mColors;
+    std::vector<std::uint8_t> mHitPoints;
+    std::vector<Component::Color> mPalette;
+};
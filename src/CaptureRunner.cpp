@@ -0,0 +1,200 @@
+#include "FrameWriter.hpp"
+#include "Rasterizer.hpp"
+#include "Scene.hpp"
+#include "Simulation.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace {
+    struct Options {
+        std::uint64_t frames = 600;
+        std::uint32_t ticksPerFrame = 4;
+        float tickRate = 240.0f;
+        int width = Scene::width;
+        int height = Scene::height;
+        Rasterizer::Format format = Rasterizer::Format::RGBA8;
+        FrameWriter::Container container = FrameWriter::Container::Y4M;
+        std::string outputPath = "-";
+        std::uint32_t seed = 1;
+        Simulation::Config config;
+        std::string levelPath;
+    };
+
+    // Holds a random direction (or none) for a random number of ticks.
+    class RandomInput {
+    public:
+        explicit RandomInput(std::uint32_t seed) : mRandom(seed) {}
+
+        Simulation::Input operator()() {
+            if (mHold == 0) {
+                const int choice = std::uniform_int_distribution<int>(0, 2)(mRandom);
+                mInput.left = choice == 1;
+                mInput.right = choice == 2;
+                mHold = std::uniform_int_distribution<std::uint32_t>(1, 120)(mRandom);
+            }
+            --mHold;
+            return mInput;
+        }
+
+    private:
+        std::mt19937 mRandom;
+        Simulation::Input mInput;
+        std::uint32_t mHold = 0;
+    };
+
+    void printUsage(const char *program) {
+        std::fprintf(stderr,
+                     "Usage: %s [options]\n"
+                     "Plays a game with random input and streams its frames, e.g.\n"
+                     "  %s --frames 3600 | ffmpeg -i - capture.mp4\n"
+                     "  --frames N        frames to write (default 600)\n"
+                     "  --ticks-per-frame N fixed updates between frames (default 4)\n"
+                     "  --tick-rate HZ    fixed update rate (default 240)\n"
+                     "  --size WxH        frame size; the playfield is stretched over it (default 800x600)\n"
+                     "  --gray            one byte of luma per pixel instead of RGB\n"
+                     "  --format F        y4m or ppm (default y4m)\n"
+                     "  --output FILE     where to write, - for stdout (default -)\n"
+                     "  --seed N          seed of the random input (default 1)\n"
+                     "  --balls N         balls per game (default 1)\n"
+                     "  --level FILE      play a binary level instead of the built-in one\n"
+                     "  --dense-bricks    keep bricks in a bitset grid instead of entities\n"
+                     "  --multi-ball      balls bounce off each other; the game ends with the last one\n",
+                     program, program);
+    }
+
+    bool parseOptions(int argc, char **argv, Options &options) {
+        for (int index = 1; index < argc; ++index) {
+            const std::string_view argument = argv[index];
+            if (argument == "--gray") {
+                options.format = Rasterizer::Format::Gray8;
+                continue;
+            }
+            if (argument == "--dense-bricks") {
+                options.config.denseBricks = true;
+                continue;
+            }
+            if (argument == "--multi-ball") {
+                options.config.multiBall = true;
+                continue;
+            }
+            if (index + 1 == argc) {
+                return false;
+            }
+            const char *value = argv[++index];
+            if (argument == "--frames") {
+                options.frames = std::strtoull(value, nullptr, 10);
+            } else if (argument == "--ticks-per-frame") {
+                options.ticksPerFrame = static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10));
+            } else if (argument == "--tick-rate") {
+                options.tickRate = std::strtof(value, nullptr);
+            } else if (argument == "--size") {
+                char *end = nullptr;
+                options.width = static_cast<int>(std::strtol(value, &end, 10));
+                if (*end != 'x') {
+                    return false;
+                }
+                options.height = static_cast<int>(std::strtol(end + 1, nullptr, 10));
+            } else if (argument == "--format") {
+                const std::string_view format = value;
+                if (format == "y4m") {
+                    options.container = FrameWriter::Container::Y4M;
+                } else if (format == "ppm") {
+                    options.container = FrameWriter::Container::PPM;
+                } else {
+                    return false;
+                }
+            } else if (argument == "--output") {
+                options.outputPath = value;
+            } else if (argument == "--seed") {
+                options.seed = static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10));
+            } else if (argument == "--balls") {
+                options.config.balls = static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10));
+            } else if (argument == "--level") {
+                options.levelPath = value;
+            } else {
+                return false;
+            }
+        }
+        return options.tickRate > 0.0f && options.ticksPerFrame > 0 && options.width > 0 && options.height > 0;
+    }
+}// namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    Level::File level;
+    if (!options.levelPath.empty() && !level.open(options.levelPath)) {
+        std::fprintf(stderr, "Failed to open level %s\n", options.levelPath.c_str());
+        return EXIT_FAILURE;
+    }
+
+    std::FILE *file = stdout;
+    if (options.outputPath != "-") {
+        file = std::fopen(options.outputPath.c_str(), "wb");
+        if (!file) {
+            std::fprintf(stderr, "Failed to open %s\n", options.outputPath.c_str());
+            return EXIT_FAILURE;
+        }
+    } else {
+#if defined(_WIN32)
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    }
+
+    Simulation simulation(options.config, level.isOpen() ? &level : nullptr);
+    simulation.reset();
+    RandomInput input(options.seed);
+
+    const std::ptrdiff_t pitch = static_cast<std::ptrdiff_t>(static_cast<std::size_t>(options.width) * Rasterizer::getBytesPerPixel(options.format));
+    std::vector<std::uint8_t> pixels(static_cast<std::size_t>(pitch) * static_cast<std::size_t>(options.height));
+    Rasterizer rasterizer;
+    rasterizer.setTarget(pixels.data(), options.width, options.height, pitch, options.format);
+    const int framesPerSecond = std::max(static_cast<int>(options.tickRate / static_cast<float>(options.ticksPerFrame) + 0.5f), 1);
+    FrameWriter writer(file, options.container, options.width, options.height, options.format, framesPerSecond);
+
+    const float fixedDeltaTime = 1.0f / options.tickRate;
+    double rasterizeSeconds = 0.0;
+    const auto start = std::chrono::steady_clock::now();
+    std::uint64_t frame = 0;
+    for (; frame < options.frames; ++frame) {
+        for (std::uint32_t tick = 0; tick < options.ticksPerFrame; ++tick) {
+            simulation.fixedUpdate(fixedDeltaTime, input());
+            simulation.update();
+        }
+
+        const auto rasterizeStart = std::chrono::steady_clock::now();
+        Scene::rasterize(simulation, rasterizer);
+        rasterizeSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - rasterizeStart).count();
+
+        if (!writer.write(pixels.data(), pitch)) {
+            std::fprintf(stderr, "Failed to write frame %llu\n", static_cast<unsigned long long>(frame));
+            break;
+        }
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    if (file != stdout) {
+        std::fclose(file);
+    } else {
+        std::fflush(stdout);
+    }
+
+    std::fprintf(stderr, "frames: %llu at %dx%d in %.3f s (%.0f frames/s, rasterizing alone %.0f frames/s with %s)\n", static_cast<unsigned long long>(frame), options.width, options.height,
+                 elapsed.count(), static_cast<double>(frame) / elapsed.count(), static_cast<double>(frame) / rasterizeSeconds, Collision::toString(Collision::getInstructionSet()));
+    return frame == options.frames ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,295 @@
+#include "Collision.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#define BREAKOUT_COLLISION_AVX2
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BREAKOUT_COLLISION_SSE2
+#endif
+#endif
+
+#if defined(__GNUC__)
+#define BREAKOUT_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define BREAKOUT_TARGET_AVX2
+#endif
+
+namespace Collision {
+    namespace {
+        // Lanes of the widest kernel; box storage is padded to a multiple of it.
+        constexpr std::size_t maxLanes = 8;
+
+        // Turns the per-axis entry times of a pair that touches within the
+        // displacement into a contact. Shared by the single and batched sweeps
+        // so both produce identical results.
+        std::optional<Contact> resolve(glm::vec2 minAPosition, glm::vec2 maxAPosition, glm::vec2 minBPosition, glm::vec2 maxBPosition, glm::vec2 displacement, glm::vec2 entry) {
+            const float entryTime = glm::max(entry.x, entry.y);
+            if (entryTime >= 0.0f) {
+                if (entry.x > entry.y) {
+                    return Contact{entryTime, glm::vec2(displacement.x > 0.0f ? -1.0f : 1.0f, 0.0f)};
+                }
+                return Contact{entryTime, glm::vec2(0.0f, displacement.y > 0.0f ? -1.0f : 1.0f)};
+            }
+
+            // Already overlapping: push out along the axis of least penetration.
+            const float left = maxAPosition.x - minBPosition.x;
+            const float right = maxBPosition.x - minAPosition.x;
+            const float top = maxAPosition.y - minBPosition.y;
+            const float bottom = maxBPosition.y - minAPosition.y;
+
+            glm::vec2 normal(left < right ? -1.0f : 1.0f, 0.0f);
+            if (glm::min(top, bottom) < glm::min(left, right)) {
+                normal = glm::vec2(0.0f, top < bottom ? -1.0f : 1.0f);
+            }
+            if (glm::dot(displacement, normal) >= 0.0f) {
+                return std::nullopt;
+            }
+            return Contact{0.0f, normal};
+        }
+
+        std::optional<Contact> sweep(glm::vec2 minAPosition, glm::vec2 maxAPosition, glm::vec2 minBPosition, glm::vec2 maxBPosition, glm::vec2 displacement) {
+            constexpr float infinity = std::numeric_limits<float>::infinity();
+
+            // Times at which the projections on each axis start and stop overlapping.
+            glm::vec2 entry(-infinity, -infinity);
+            glm::vec2 exit(infinity, infinity);
+            for (int axis = 0; axis < 2; ++axis) {
+                if (displacement[axis] > 0.0f) {
+                    entry[axis] = (minBPosition[axis] - maxAPosition[axis]) / displacement[axis];
+                    exit[axis] = (maxBPosition[axis] - minAPosition[axis]) / displacement[axis];
+                } else if (displacement[axis] < 0.0f) {
+                    entry[axis] = (maxBPosition[axis] - minAPosition[axis]) / displacement[axis];
+                    exit[axis] = (minBPosition[axis] - maxAPosition[axis]) / displacement[axis];
+                } else if (maxAPosition[axis] <= minBPosition[axis] || minAPosition[axis] >= maxBPosition[axis]) {
+                    return std::nullopt;
+                }
+            }
+
+            const float entryTime = glm::max(entry.x, entry.y);
+            const float exitTime = glm::min(exit.x, exit.y);
+            if (entryTime >= exitTime || exitTime <= 0.0f || entryTime > 1.0f) {
+                return std::nullopt;
+            }
+            return resolve(minAPosition, maxAPosition, minBPosition, maxBPosition, displacement, entry);
+        }
+
+        std::optional<BatchContact> sweepScalar(const Component::Transform &transformA, glm::vec2 displacement, const Boxes &boxes) {
+            const glm::vec2 minAPosition = transformA.position;
+            const glm::vec2 maxAPosition = transformA.position + transformA.scale;
+
+            std::optional<BatchContact> best;
+            for (std::size_t index = 0; index < boxes.size(); ++index) {
+                const glm::vec2 minBPosition(boxes.getMinX()[index], boxes.getMinY()[index]);
+                const glm::vec2 maxBPosition(boxes.getMaxX()[index], boxes.getMaxY()[index]);
+                const auto contact = sweep(minAPosition, maxAPosition, minBPosition, maxBPosition, displacement);
+                if (contact && (!best || contact->time < best->contact.time)) {
+                    best = BatchContact{index, *contact};
+                }
+            }
+            return best;
+        }
+
+#if defined(BREAKOUT_COLLISION_SSE2) || defined(BREAKOUT_COLLISION_AVX2)
+        // The vector kernels only reject pairs: lanes that survive are resolved
+        // one by one in box order, which keeps the first box on ties.
+        void resolveLanes(std::uint32_t mask, std::size_t first, const float *entryX, const float *entryY, glm::vec2 minAPosition, glm::vec2 maxAPosition, glm::vec2 displacement, const Boxes &boxes, std::optional<BatchContact> &best) {
+            while (mask != 0) {
+                const int lane = std::countr_zero(mask);
+                mask &= mask - 1;
+                const std::size_t index = first + static_cast<std::size_t>(lane);
+                const glm::vec2 minBPosition(boxes.getMinX()[index], boxes.getMinY()[index]);
+                const glm::vec2 maxBPosition(boxes.getMaxX()[index], boxes.getMaxY()[index]);
+                const auto contact = resolve(minAPosition, maxAPosition, minBPosition, maxBPosition, displacement, glm::vec2(entryX[lane], entryY[lane]));
+                if (contact && (!best || contact->time < best->contact.time)) {
+                    best = BatchContact{index, *contact};
+                }
+            }
+        }
+
+        // Lanes of a block starting at first that hold boxes rather than padding.
+        std::uint32_t getLaneMask(std::size_t first, std::size_t size, std::size_t lanes) {
+            const std::size_t count = size - first;
+            return count >= lanes ? (1u << lanes) - 1u : (1u << count) - 1u;
+        }
+#endif
+
+#if defined(BREAKOUT_COLLISION_SSE2)
+        // Entry and exit times of four boxes on one axis; a still axis rejects the lanes it does not overlap.
+        void sweepAxisSSE2(float minA, float maxA, float displacement, __m128 minB, __m128 maxB, __m128 &entry, __m128 &exit, __m128 &reject) {
+            const __m128 divisor = _mm_set1_ps(displacement);
+            if (displacement > 0.0f) {
+                entry = _mm_div_ps(_mm_sub_ps(minB, _mm_set1_ps(maxA)), divisor);
+                exit = _mm_div_ps(_mm_sub_ps(maxB, _mm_set1_ps(minA)), divisor);
+            } else if (displacement < 0.0f) {
+                entry = _mm_div_ps(_mm_sub_ps(maxB, _mm_set1_ps(minA)), divisor);
+                exit = _mm_div_ps(_mm_sub_ps(minB, _mm_set1_ps(maxA)), divisor);
+            } else {
+                entry = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+                exit = _mm_set1_ps(std::numeric_limits<float>::infinity());
+                reject = _mm_or_ps(reject, _mm_or_ps(_mm_cmple_ps(_mm_set1_ps(maxA), minB), _mm_cmpge_ps(_mm_set1_ps(minA), maxB)));
+            }
+        }
+
+        std::optional<BatchContact> sweepSSE2(const Component::Transform &transformA, glm::vec2 displacement, const Boxes &boxes) {
+            const glm::vec2 minAPosition = transformA.position;
+            const glm::vec2 maxAPosition = transformA.position + transformA.scale;
+
+            alignas(16) float entryX[4];
+            alignas(16) float entryY[4];
+            std::optional<BatchContact> best;
+            for (std::size_t first = 0; first < boxes.size(); first += 4) {
+                __m128 entryXs, exitXs, entryYs, exitYs;
+                __m128 reject = _mm_setzero_ps();
+                sweepAxisSSE2(minAPosition.x, maxAPosition.x, displacement.x, _mm_loadu_ps(boxes.getMinX() + first), _mm_loadu_ps(boxes.getMaxX() + first), entryXs, exitXs, reject);
+                sweepAxisSSE2(minAPosition.y, maxAPosition.y, displacement.y, _mm_loadu_ps(boxes.getMinY() + first), _mm_loadu_ps(boxes.getMaxY() + first), entryYs, exitYs, reject);
+
+                const __m128 entryTime = _mm_max_ps(entryXs, entryYs);
+                const __m128 exitTime = _mm_min_ps(exitXs, exitYs);
+                const __m128 hit = _mm_and_ps(_mm_and_ps(_mm_cmplt_ps(entryTime, exitTime), _mm_cmpgt_ps(exitTime, _mm_setzero_ps())), _mm_cmple_ps(entryTime, _mm_set1_ps(1.0f)));
+                const std::uint32_t mask = static_cast<std::uint32_t>(_mm_movemask_ps(_mm_andnot_ps(reject, hit))) & getLaneMask(first, boxes.size(), 4);
+                if (mask != 0) {
+                    _mm_store_ps(entryX, entryXs);
+                    _mm_store_ps(entryY, entryYs);
+                    resolveLanes(mask, first, entryX, entryY, minAPosition, maxAPosition, displacement, boxes, best);
+                }
+            }
+            return best;
+        }
+#endif
+
+#if defined(BREAKOUT_COLLISION_AVX2)
+        BREAKOUT_TARGET_AVX2 void sweepAxisAVX2(float minA, float maxA, float displacement, __m256 minB, __m256 maxB, __m256 &entry, __m256 &exit, __m256 &reject) {
+            const __m256 divisor = _mm256_set1_ps(displacement);
+            if (displacement > 0.0f) {
+                entry = _mm256_div_ps(_mm256_sub_ps(minB, _mm256_set1_ps(maxA)), divisor);
+                exit = _mm256_div_ps(_mm256_sub_ps(maxB, _mm256_set1_ps(minA)), divisor);
+            } else if (displacement < 0.0f) {
+                entry = _mm256_div_ps(_mm256_sub_ps(maxB, _mm256_set1_ps(minA)), divisor);
+                exit = _mm256_div_ps(_mm256_sub_ps(minB, _mm256_set1_ps(maxA)), divisor);
+            } else {
+                entry = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+                exit = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+                reject = _mm256_or_ps(reject, _mm256_or_ps(_mm256_cmp_ps(_mm256_set1_ps(maxA), minB, _CMP_LE_OQ), _mm256_cmp_ps(_mm256_set1_ps(minA), maxB, _CMP_GE_OQ)));
+            }
+        }
+
+        BREAKOUT_TARGET_AVX2 std::optional<BatchContact> sweepAVX2(const Component::Transform &transformA, glm::vec2 displacement, const Boxes &boxes) {
+            const glm::vec2 minAPosition = transformA.position;
+            const glm::vec2 maxAPosition = transformA.position + transformA.scale;
+
+            alignas(32) float entryX[8];
+            alignas(32) float entryY[8];
+            std::optional<BatchContact> best;
+            for (std::size_t first = 0; first < boxes.size(); first += 8) {
+                __m256 entryXs, exitXs, entryYs, exitYs;
+                __m256 reject = _mm256_setzero_ps();
+                sweepAxisAVX2(minAPosition.x, maxAPosition.x, displacement.x, _mm256_loadu_ps(boxes.getMinX() + first), _mm256_loadu_ps(boxes.getMaxX() + first), entryXs, exitXs, reject);
+                sweepAxisAVX2(minAPosition.y, maxAPosition.y, displacement.y, _mm256_loadu_ps(boxes.getMinY() + first), _mm256_loadu_ps(boxes.getMaxY() + first), entryYs, exitYs, reject);
+
+                const __m256 entryTime = _mm256_max_ps(entryXs, entryYs);
+                const __m256 exitTime = _mm256_min_ps(exitXs, exitYs);
+                const __m256 hit = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(entryTime, exitTime, _CMP_LT_OQ), _mm256_cmp_ps(exitTime, _mm256_setzero_ps(), _CMP_GT_OQ)), _mm256_cmp_ps(entryTime, _mm256_set1_ps(1.0f), _CMP_LE_OQ));
+                const std::uint32_t mask = static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_andnot_ps(reject, hit))) & getLaneMask(first, boxes.size(), 8);
+                if (mask != 0) {
+                    _mm256_store_ps(entryX, entryXs);
+                    _mm256_store_ps(entryY, entryYs);
+                    resolveLanes(mask, first, entryX, entryY, minAPosition, maxAPosition, displacement, boxes, best);
+                }
+            }
+            return best;
+        }
+
+        bool hasAVX2() {
+#if defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 1);
+            const bool osxsave = (info[2] & (1 << 27)) != 0;
+            const bool avx = (info[2] & (1 << 28)) != 0;
+            if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+                return false;
+            }
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#else
+            return __builtin_cpu_supports("avx2");
+#endif
+        }
+#endif
+
+        InstructionSet detectInstructionSet() {
+#if defined(BREAKOUT_COLLISION_AVX2)
+            if (hasAVX2()) {
+                return InstructionSet::AVX2;
+            }
+#endif
+#if defined(BREAKOUT_COLLISION_SSE2)
+            return InstructionSet::SSE2;
+#else
+            return InstructionSet::Scalar;
+#endif
+        }
+    }// namespace
+
+    bool overlaps(const Component::Transform &transformA, const Component::Transform &transformB) {
+        const glm::vec2 maxAPosition = transformA.position + transformA.scale;
+        const glm::vec2 maxBPosition = transformB.position + transformB.scale;
+        return maxAPosition.x > transformB.position.x && transformA.position.x < maxBPosition.x && maxAPosition.y > transformB.position.y && transformA.position.y < maxBPosition.y;
+    }
+
+    std::optional<Contact> sweep(const Component::Transform &transformA, glm::vec2 displacement, const Component::Transform &transformB) {
+        return sweep(transformA.position, transformA.position + transformA.scale, transformB.position, transformB.position + transformB.scale, displacement);
+    }
+
+    void Boxes::add(const Component::Transform &transform) {
+        if (mSize == mMinX.size()) {
+            mMinX.resize(mSize + maxLanes);
+            mMinY.resize(mSize + maxLanes);
+            mMaxX.resize(mSize + maxLanes);
+            mMaxY.resize(mSize + maxLanes);
+        }
+        const glm::vec2 maxPosition = transform.position + transform.scale;
+        mMinX[mSize] = transform.position.x;
+        mMinY[mSize] = transform.position.y;
+        mMaxX[mSize] = maxPosition.x;
+        mMaxY[mSize] = maxPosition.y;
+        ++mSize;
+    }
+
+    InstructionSet getInstructionSet() {
+        static const InstructionSet instructionSet = detectInstructionSet();
+        return instructionSet;
+    }
+
+    const char *toString(InstructionSet instructionSet) {
+        switch (instructionSet) {
+            case InstructionSet::SSE2:
+                return "sse2";
+            case InstructionSet::AVX2:
+                return "avx2";
+            default:
+                return "scalar";
+        }
+    }
+
+    std::optional<BatchContact> sweep(const Component::Transform &transformA, glm::vec2 displacement, const Boxes &boxes, InstructionSet instructionSet) {
+        switch (instructionSet) {
+#if defined(BREAKOUT_COLLISION_AVX2)
+            case InstructionSet::AVX2:
+                return sweepAVX2(transformA, displacement, boxes);
+#endif
+#if defined(BREAKOUT_COLLISION_SSE2)
+            case InstructionSet::SSE2:
+                return sweepSSE2(transformA, displacement, boxes);
+#endif
+            default:
+                return sweepScalar(transformA, displacement, boxes);
+        }
+    }
+}// namespace Collision
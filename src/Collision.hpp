@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Component.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace Collision {
+    struct Contact {
+        // Fraction of the displacement travelled before the boxes touch, in [0, 1].
+        float time;
+        // Axis-aligned unit normal of the touched face, pointing towards the moving box.
+        glm::vec2 normal;
+    };
+
+    bool overlaps(const Component::Transform &transformA, const Component::Transform &transformB);
+
+    // Moves transformA by displacement against the static transformB and returns
+    // the earliest contact. Boxes that already overlap report a contact at time 0
+    // only while the displacement pushes further in, so a ball can always leave.
+    std::optional<Contact> sweep(const Component::Transform &transformA, glm::vec2 displacement, const Component::Transform &transformB);
+
+    // Static boxes in structure-of-arrays form for the batched sweep. Storage is
+    // padded to whole vectors of the widest instruction set, so kernels never
+    // load past the end.
+    class Boxes {
+    public:
+        void clear() { mSize = 0; }
+        void add(const Component::Transform &transform);
+
+        [[nodiscard]] std::size_t size() const { return mSize; }
+        [[nodiscard]] bool empty() const { return mSize == 0; }
+
+        [[nodiscard]] const float *getMinX() const { return mMinX.data(); }
+        [[nodiscard]] const float *getMinY() const { return mMinY.data(); }
+        [[nodiscard]] const float *getMaxX() const { return mMaxX.data(); }
+        [[nodiscard]] const float *getMaxY() const { return mMaxY.data(); }
+
+    private:
+        std::size_t mSize = 0;
+        std::vector<float> mMinX;
+        std::vector<float> mMinY;
+        std::vector<float> mMaxX;
+        std::vector<float> mMaxY;
+    };
+
+    struct BatchContact {
+        // Index of the touched box in the batch.
+        std::size_t index;
+        Contact contact;
+    };
+
+    enum class InstructionSet { Scalar, SSE2, AVX2 };
+
+    // Widest instruction set supported by both the build and the running CPU.
+    InstructionSet getInstructionSet();
+    const char *toString(InstructionSet instructionSet);
+
+    // Same as sweeping transformA against every box in order and keeping the
+    // earliest contact (the first box wins ties); results are bit-identical to
+    // the single-box sweep whatever instruction set is used. The instruction set
+    // must not be wider than getInstructionSet().
+    std::optional<BatchContact> sweep(const Component::Transform &transformA, glm::vec2 displacement, const Boxes &boxes, InstructionSet instructionSet = getInstructionSet());
+}// namespace Collision
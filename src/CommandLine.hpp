@@ -0,0 +1,19 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdlib>
+
+// Argument parsing shared by the headless tools.
+namespace CommandLine {
+    // Parses "XxY" into a vector.
+    inline bool parseVector(const char *value, glm::vec2 &vector) {
+        char *end = nullptr;
+        vector.x = std::strtof(value, &end);
+        if (*end != 'x') {
+            return false;
+        }
+        vector.y = std::strtof(end + 1, nullptr);
+        return true;
+    }
+}// namespace CommandLine
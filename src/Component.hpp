@@ -2,24 +2,42 @@
 
 #include <glm/glm.hpp>
 
-#include <string>
+#include <cstdint>
 
 namespace Component {
+    // Hits a brick takes before it breaks; bricks without it break on the first hit.
+    struct Health {
+        std::uint8_t hitPoints;
+    };
+
     struct Movement {
         glm::vec2 velocity;
     };
 
+    // 8 bits per channel in the byte order SDL_Color and the Rasterizer use,
+    // so drawing copies it as is.
+    struct Color {
+        std::uint8_t r;
+        std::uint8_t g;
+        std::uint8_t b;
+        std::uint8_t a;
+    };
+    static_assert(sizeof(Color) == 4);
+
     struct Sprite {
-        glm::vec4 color;
+        Color color;
     };
 
+    // Top-left corner and extent of an axis-aligned box.
     struct Transform {
         glm::vec2 position;
-        glm::vec2 rotation;
         glm::vec2 scale;
     };
+    static_assert(sizeof(Transform) == 16);
 
-    struct Tag {
-        std::string name;
-    };
+    struct Ball {};
+    struct Brick {};
+    struct Goal {};
+    struct Paddle {};
+    struct Wall {};
 }// namespace Component
@@ -0,0 +1,134 @@
+/* Measures BreakoutEnv throughput in environment steps per second for a
+ * growing number of threads. Written in C to keep the API honest. */
+
+#include "BreakoutEnv.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double now(void) {
+    struct timespec time;
+    timespec_get(&time, TIME_UTC);
+    return (double) time.tv_sec + (double) time.tv_nsec * 1e-9;
+}
+
+static void printUsage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --envs N          games stepped together (default 256)\n"
+            "  --threads N       largest thread count measured (default: all cores)\n"
+            "  --steps N         steps per measurement (default 2000)\n"
+            "  --ticks-per-step N fixed updates per step (default 4)\n"
+            "  --balls N         balls per game (default 1)\n"
+            "  --level FILE      play a binary level instead of the built-in one\n"
+            "  --dense-bricks    keep bricks in a bitset grid instead of entities\n",
+            program);
+}
+
+int main(int argc, char **argv) {
+    BreakoutEnvConfig config;
+    breakout_env_default_config(&config);
+    config.envCount = 256;
+    config.ticksPerStep = 4;
+    unsigned long maxThreads = 0;
+    unsigned long steps = 2000;
+
+    for (int index = 1; index < argc; ++index) {
+        const char *argument = argv[index];
+        const char *value = index + 1 < argc ? argv[index + 1] : NULL;
+        if (strcmp(argument, "--dense-bricks") == 0) {
+            config.denseBricks = 1;
+            continue;
+        }
+        if (!value) {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        ++index;
+        if (strcmp(argument, "--envs") == 0) {
+            config.envCount = (uint32_t) strtoul(value, NULL, 10);
+        } else if (strcmp(argument, "--threads") == 0) {
+            maxThreads = strtoul(value, NULL, 10);
+        } else if (strcmp(argument, "--steps") == 0) {
+            steps = strtoul(value, NULL, 10);
+        } else if (strcmp(argument, "--ticks-per-step") == 0) {
+            config.ticksPerStep = (uint32_t) strtoul(value, NULL, 10);
+        } else if (strcmp(argument, "--balls") == 0) {
+            config.balls = (uint32_t) strtoul(value, NULL, 10);
+        } else if (strcmp(argument, "--level") == 0) {
+            config.levelPath = value;
+        } else {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (maxThreads == 0) {
+        config.threads = 0;
+        BreakoutEnv *env = breakout_env_create(&config);
+        if (!env) {
+            fprintf(stderr, "Failed to create the environments\n");
+            return EXIT_FAILURE;
+        }
+        maxThreads = breakout_env_thread_count(env);
+        breakout_env_destroy(env);
+    }
+
+    printf("threads,env_steps,seconds,env_steps_per_second,speedup\n");
+    double baseline = 0.0;
+    /* Doubles the thread count up to maxThreads, measuring maxThreads itself last. */
+    for (unsigned long threads = 1;; threads = threads * 2 < maxThreads ? threads * 2 : maxThreads) {
+        config.threads = (uint32_t) threads;
+        BreakoutEnv *env = breakout_env_create(&config);
+        if (!env) {
+            fprintf(stderr, "Failed to create the environments\n");
+            return EXIT_FAILURE;
+        }
+
+        const size_t count = breakout_env_count(env);
+        float *observations = malloc(count * breakout_env_observation_size(env) * sizeof(float));
+        float *rewards = malloc(count * sizeof(float));
+        uint8_t *dones = malloc(count);
+        uint8_t *actions = malloc(count);
+        breakout_env_set_buffers(env, observations, rewards, dones);
+        breakout_env_reset(env);
+
+        /* Random actions from a small LCG, held for a few steps like the batch runner's policy. */
+        uint32_t random = 1;
+        double reward = 0.0;
+        unsigned long episodes = 0;
+        const double start = now();
+        for (unsigned long step = 0; step < steps; ++step) {
+            if (step % 8 == 0) {
+                for (size_t game = 0; game < count; ++game) {
+                    random = random * 1664525u + 1013904223u;
+                    actions[game] = (uint8_t) ((random >> 16) % 3);
+                }
+            }
+            breakout_env_step(env, actions);
+            for (size_t game = 0; game < count; ++game) {
+                reward += rewards[game];
+                episodes += dones[game];
+            }
+        }
+        const double seconds = now() - start;
+        const double rate = (double) (count * steps) / seconds;
+        if (threads == 1) {
+            baseline = rate;
+        }
+        printf("%lu,%lu,%.3f,%.0f,%.2f\n", threads, (unsigned long) (count * steps), seconds, rate, rate / baseline);
+        fprintf(stderr, "threads %lu: %lu episodes, total reward %.0f\n", threads, episodes, reward);
+
+        free(actions);
+        free(dones);
+        free(rewards);
+        free(observations);
+        breakout_env_destroy(env);
+        if (threads >= maxThreads) {
+            break;
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Component.hpp"
+
+#include <entt/entt.hpp>
+
+namespace Event {
+    struct BrickDestroyed {
+        Component::Transform transform;
+        Component::Sprite sprite;
+    };
+
+    struct BricksRespawned {};
+
+    // A ball reached the goal; the game is over unless other balls are
+    // still in play with Simulation::Config::multiBall.
+    struct BallLost {
+        entt::entity ball;
+    };
+
+    // The last brick was destroyed; the game is over.
+    struct LevelCleared {};
+}// namespace Event
@@ -0,0 +1,74 @@
+#include "FrameWriter.hpp"
+
+#include <cstring>
+
+namespace {
+    // Studio-swing BT.601 in integers, the default that players and ffmpeg
+    // assume. Plain loops over whole rows, which compilers vectorize.
+    void convertRow(const std::uint8_t *pixels, std::size_t width, std::uint8_t *rowY, std::uint8_t *rowU, std::uint8_t *rowV) {
+        for (std::size_t x = 0; x < width; ++x) {
+            std::uint32_t pixel = 0;
+            std::memcpy(&pixel, pixels + x * 4, sizeof(pixel));
+            const auto r = static_cast<std::int32_t>(pixel & 0xFFu);
+            const auto g = static_cast<std::int32_t>((pixel >> 8) & 0xFFu);
+            const auto b = static_cast<std::int32_t>((pixel >> 16) & 0xFFu);
+            rowY[x] = static_cast<std::uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+            rowU[x] = static_cast<std::uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+            rowV[x] = static_cast<std::uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
+    }
+}// namespace
+
+FrameWriter::FrameWriter(std::FILE *file, Container container, int width, int height, Rasterizer::Format format, int framesPerSecond)
+    : mFile(file), mContainer(container), mWidth(width), mHeight(height), mFormat(format), mFramesPerSecond(framesPerSecond) {
+    const std::size_t pixels = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+    mBuffer.resize(format == Rasterizer::Format::RGBA8 ? pixels * 3 : pixels);
+}
+
+bool FrameWriter::write(const std::uint8_t *pixels, std::ptrdiff_t pitch) {
+    return mContainer == Container::Y4M ? writeY4M(pixels, pitch) : writePPM(pixels, pitch);
+}
+
+bool FrameWriter::writeY4M(const std::uint8_t *pixels, std::ptrdiff_t pitch) {
+    if (!mHeaderWritten) {
+        std::fprintf(mFile, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 %s\n", mWidth, mHeight, mFramesPerSecond, mFormat == Rasterizer::Format::RGBA8 ? "C444" : "Cmono");
+        mHeaderWritten = true;
+    }
+    std::fputs("FRAME\n", mFile);
+
+    const std::size_t planeSize = static_cast<std::size_t>(mWidth) * static_cast<std::size_t>(mHeight);
+    if (mFormat == Rasterizer::Format::Gray8) {
+        for (int y = 0; y < mHeight; ++y) {
+            std::memcpy(mBuffer.data() + static_cast<std::size_t>(y) * static_cast<std::size_t>(mWidth), pixels + y * pitch, static_cast<std::size_t>(mWidth));
+        }
+    } else {
+        std::uint8_t *planeY = mBuffer.data();
+        std::uint8_t *planeU = planeY + planeSize;
+        std::uint8_t *planeV = planeU + planeSize;
+        for (int y = 0; y < mHeight; ++y) {
+            const std::size_t offset = static_cast<std::size_t>(y) * static_cast<std::size_t>(mWidth);
+            convertRow(pixels + y * pitch, static_cast<std::size_t>(mWidth), planeY + offset, planeU + offset, planeV + offset);
+        }
+    }
+    return std::fwrite(mBuffer.data(), 1, mBuffer.size(), mFile) == mBuffer.size() && std::ferror(mFile) == 0;
+}
+
+bool FrameWriter::writePPM(const std::uint8_t *pixels, std::ptrdiff_t pitch) {
+    std::fprintf(mFile, "%s\n%d %d\n255\n", mFormat == Rasterizer::Format::RGBA8 ? "P6" : "P5", mWidth, mHeight);
+
+    std::uint8_t *output = mBuffer.data();
+    for (int y = 0; y < mHeight; ++y) {
+        const std::uint8_t *row = pixels + y * pitch;
+        if (mFormat == Rasterizer::Format::Gray8) {
+            std::memcpy(output, row, static_cast<std::size_t>(mWidth));
+            output += mWidth;
+            continue;
+        }
+        for (int x = 0; x < mWidth; ++x, row += 4) {
+            *output++ = row[0];
+            *output++ = row[1];
+            *output++ = row[2];
+        }
+    }
+    return std::fwrite(mBuffer.data(), 1, mBuffer.size(), mFile) == mBuffer.size() && std::ferror(mFile) == 0;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Rasterizer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Streams raw frames to a file or pipe, e.g. into ffmpeg:
+//   Y4M: one YUV4MPEG2 stream, 4:4:4 BT.601 from RGBA8 or mono from Gray8
+//   PPM: one binary PPM (P6) per RGBA8 frame or PGM (P5) per Gray8 frame,
+//        back to back, as read by ffmpeg's image2pipe
+class FrameWriter {
+public:
+    enum class Container : std::uint8_t { Y4M, PPM };
+
+    // The file is not closed by the writer.
+    FrameWriter(std::FILE *file, Container container, int width, int height, Rasterizer::Format format, int framesPerSecond);
+
+    // Writes one frame of the size and format given to the constructor;
+    // returns false once the file fails, e.g. when the reader went away.
+    bool write(const std::uint8_t *pixels, std::ptrdiff_t pitch);
+
+private:
+    bool writeY4M(const std::uint8_t *pixels, std::ptrdiff_t pitch);
+    bool writePPM(const std::uint8_t *pixels, std::ptrdiff_t pitch);
+
+    std::FILE *mFile;
+    Container mContainer;
+    int mWidth;
+    int mHeight;
+    Rasterizer::Format mFormat;
+    int mFramesPerSecond;
+    bool mHeaderWritten = false;
+    // One converted frame, reused so writing does not allocate.
+    std::vector<std::uint8_t> mBuffer;
+};
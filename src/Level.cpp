@@ -0,0 +1,265 @@
+#include "Level.hpp"
+
+#include <cstring>
+#include <sstream>
+
+namespace Level {
+    namespace {
+        // Palette index of a brick character: 0-9 then a-z, or -1.
+        int toColorIndex(char character) {
+            if (character >= '0' && character <= '9') {
+                return character - '0';
+            }
+            if (character >= 'a' && character <= 'z') {
+                return character - 'a' + 10;
+            }
+            return -1;
+        }
+
+        template<typename T>
+        void append(std::vector<std::uint8_t> &bytes, const T &value) {
+            const auto *data = reinterpret_cast<const std::uint8_t *>(&value);
+            bytes.insert(bytes.end(), data, data + sizeof(T));
+        }
+
+        bool readBox(std::istringstream &stream, Box &box) {
+            return static_cast<bool>(stream >> box.x >> box.y >> box.width >> box.height);
+        }
+    }// namespace
+
+    Description makeDefault(std::uint32_t rows, std::uint32_t columns, glm::vec2 brickSize) {
+        Description description;
+        description.goal = Box{0.0f, 600.0f, 800.0f, 20.0f};
+        description.paddle = Box{0.5f * (800.0f - 80.0f), 600.0f - 20.0f, 80.0f, 20.0f};
+        description.ball = Box{0.5f * (800.0f - 10.0f), 0.5f * (600.0f - 10.0f), 10.0f, 10.0f};
+        description.paddleSpeed = 400.0f;
+        description.walls = {
+                Box{0.0f, -20.0f, 800.0f, 20.0f}, // Top
+                Box{-20.0f, 0.0f, 20.0f, 600.0f}, // Left
+                Box{800.0f, 0.0f, 20.0f, 600.0f}, // Right
+        };
+        description.palette = {
+                {194, 57, 52, 255}, // Red
+                {255, 167, 38, 255},// Orange
+                {255, 255, 100, 255},// Yellow
+                {78, 188, 78, 255}, // Green
+                {46, 116, 181, 255},// Blue
+                {216, 64, 185, 255},// Purple
+                {255, 105, 180, 255},// Pink
+                {128, 128, 128, 255},// Gray
+        };
+        description.columns = columns;
+        description.rows = rows;
+        description.cellSize = brickSize;
+        const auto cells = static_cast<std::size_t>(getCellCount(columns, rows));
+        description.colors.resize(cells);
+        description.hitPoints.assign(cells, 1);
+        for (std::uint32_t row = 0; row < rows; ++row) {
+            std::memset(description.colors.data() + static_cast<std::size_t>(row) * columns, static_cast<int>(row % description.palette.size()), columns);
+        }
+        return description;
+    }
+
+    std::vector<std::uint8_t> serialize(const Description &description) {
+        Header header{};
+        std::memcpy(header.magic, "BRKL", sizeof(header.magic));
+        header.version = version;
+        header.goal = description.goal;
+        header.paddle = description.paddle;
+        header.ball = description.ball;
+        header.paddleSpeed = description.paddleSpeed;
+        header.wallCount = static_cast<std::uint32_t>(description.walls.size());
+        header.paletteSize = static_cast<std::uint32_t>(description.palette.size());
+        header.columns = description.columns;
+        header.rows = description.rows;
+        header.origin[0] = description.origin.x;
+        header.origin[1] = description.origin.y;
+        header.cellSize[0] = description.cellSize.x;
+        header.cellSize[1] = description.cellSize.y;
+
+        std::vector<std::uint8_t> bytes;
+        bytes.reserve(sizeof(Header) + description.walls.size() * sizeof(Box) + description.palette.size() * 4 + description.colors.size() * 2);
+        append(bytes, header);
+        for (const Box &wall: description.walls) {
+            append(bytes, wall);
+        }
+        for (const auto &color: description.palette) {
+            append(bytes, color);
+        }
+        bytes.insert(bytes.end(), description.colors.begin(), description.colors.end());
+        bytes.insert(bytes.end(), description.hitPoints.begin(), description.hitPoints.end());
+        return bytes;
+    }
+
+    std::optional<Description> parse(std::string_view text, std::string &error) {
+        // Anything the text leaves out keeps the classic layout.
+        Description description = makeDefault(0, 0, glm::vec2(80.0f, 20.0f));
+        bool customWalls = false;
+        bool customPalette = false;
+
+        std::istringstream lines{std::string(text)};
+        std::string line;
+        for (std::size_t number = 1; std::getline(lines, line); ++number) {
+            line = line.substr(0, line.find('#'));
+            std::istringstream stream(line);
+            std::string command;
+            if (!(stream >> command)) {
+                continue;
+            }
+
+            bool valid = true;
+            if (command == "goal") {
+                valid = readBox(stream, description.goal);
+            } else if (command == "paddle") {
+                valid = readBox(stream, description.paddle) && static_cast<bool>(stream >> description.paddleSpeed);
+            } else if (command == "ball") {
+                valid = readBox(stream, description.ball);
+            } else if (command == "wall") {
+                if (!customWalls) {
+                    description.walls.clear();
+                    customWalls = true;
+                }
+                Box wall{};
+                valid = readBox(stream, wall);
+                description.walls.push_back(wall);
+            } else if (command == "color") {
+                if (!customPalette) {
+                    description.palette.clear();
+                    customPalette = true;
+                }
+                int red = 0, green = 0, blue = 0, alpha = 255;
+                valid = static_cast<bool>(stream >> red >> green >> blue);
+                stream >> alpha;
+                description.palette.push_back({static_cast<std::uint8_t>(red), static_cast<std::uint8_t>(green), static_cast<std::uint8_t>(blue), static_cast<std::uint8_t>(alpha)});
+            } else if (command == "bricks") {
+                valid = static_cast<bool>(stream >> description.origin.x >> description.origin.y >> description.cellSize.x >> description.cellSize.y) && description.cellSize.x > 0.0f && description.cellSize.y > 0.0f;
+            } else if (command == "row") {
+                std::string cells;
+                std::string hits;
+                stream >> cells >> hits;
+                if (description.rows == 0) {
+                    description.columns = static_cast<std::uint32_t>(cells.size());
+                }
+                valid = !cells.empty() && cells.size() == description.columns && (hits.empty() || hits.size() == cells.size());
+                for (std::size_t column = 0; valid && column < cells.size(); ++column) {
+                    const int color = toColorIndex(cells[column]);
+                    const int hitPoints = hits.empty() ? 1 : hits[column] - '0';
+                    if (cells[column] == '.') {
+                        description.colors.push_back(0);
+                        description.hitPoints.push_back(0);
+                    } else if (color >= 0 && hitPoints >= 1 && hitPoints <= 9) {
+                        description.colors.push_back(static_cast<std::uint8_t>(color));
+                        description.hitPoints.push_back(static_cast<std::uint8_t>(hitPoints));
+                    } else {
+                        valid = false;
+                    }
+                }
+                ++description.rows;
+            } else {
+                error = "line " + std::to_string(number) + ": unknown command '" + command + "'";
+                return std::nullopt;
+            }
+            if (!valid) {
+                error = "line " + std::to_string(number) + ": invalid " + command;
+                return std::nullopt;
+            }
+        }
+
+        for (std::size_t cell = 0; cell < description.colors.size(); ++cell) {
+            if (description.hitPoints[cell] > 0 && description.colors[cell] >= description.palette.size()) {
+                error = "brick color " + std::to_string(description.colors[cell]) + " is not in the palette";
+                return std::nullopt;
+            }
+        }
+        return description;
+    }
+
+    bool File::open(const std::string &path) {
+        close();
+        if (!mFile.open(path)) {
+            return false;
+        }
+        mData = mFile.getData();
+        mSize = mFile.getSize();
+        return validate();
+    }
+
+    bool File::load(std::vector<std::uint8_t> bytes) {
+        close();
+        mBytes = std::move(bytes);
+        mData = mBytes.data();
+        mSize = mBytes.size();
+        return validate();
+    }
+
+    void File::close() {
+        mFile.close();
+        mBytes.clear();
+        mData = nullptr;
+        mSize = 0;
+        mWalls = nullptr;
+        mPalette = nullptr;
+        mColors = nullptr;
+        mHitPoints = nullptr;
+        mBrickCount = 0;
+        mHash = 0;
+    }
+
+    Box File::getWall(std::uint32_t index) const {
+        Box wall{};
+        std::memcpy(&wall, mWalls + index * sizeof(Box), sizeof(Box));
+        return wall;
+    }
+
+    Component::Color File::getColor(std::uint8_t index) const {
+        Component::Color color{};
+        std::memcpy(&color, mPalette + static_cast<std::size_t>(index) * sizeof(color), sizeof(color));
+        return color;
+    }
+
+    bool File::validate() {
+        if (mSize < sizeof(Header)) {
+            close();
+            return false;
+        }
+        std::memcpy(&mHeader, mData, sizeof(Header));
+        // Checked first so the expected size below cannot wrap.
+        const std::uint64_t cells = getCellCount(mHeader.columns, mHeader.rows);
+        if (cells > maxCells) {
+            close();
+            return false;
+        }
+        const std::uint64_t expectedSize = sizeof(Header) + static_cast<std::uint64_t>(mHeader.wallCount) * sizeof(Box) + static_cast<std::uint64_t>(mHeader.paletteSize) * 4 + cells * 2;
+        if (std::memcmp(mHeader.magic, "BRKL", sizeof(mHeader.magic)) != 0 || mHeader.version != version || expectedSize != mSize ||
+            !(mHeader.cellSize[0] > 0.0f) || !(mHeader.cellSize[1] > 0.0f)) {
+            close();
+            return false;
+        }
+        mWalls = mData + sizeof(Header);
+        mPalette = mWalls + static_cast<std::size_t>(mHeader.wallCount) * sizeof(Box);
+        mColors = mPalette + static_cast<std::size_t>(mHeader.paletteSize) * 4;
+        mHitPoints = mColors + cells;
+
+        // One pass over the cells counts the bricks and rejects colors outside
+        // the palette, so loading never has to check them again.
+        std::uint32_t bricks = 0;
+        std::uint8_t maxColor = 0;
+        for (std::size_t cell = 0; cell < cells; ++cell) {
+            const bool alive = mHitPoints[cell] != 0;
+            bricks += alive;
+            maxColor = alive && mColors[cell] > maxColor ? mColors[cell] : maxColor;
+        }
+        if (bricks > 0 && maxColor >= mHeader.paletteSize) {
+            close();
+            return false;
+        }
+        mBrickCount = bricks;
+
+        std::uint32_t hash = 0x811C9DC5u;
+        for (std::size_t index = 0; index < mSize; ++index) {
+            hash = (hash ^ mData[index]) * 0x01000193u;
+        }
+        mHash = hash;
+        return true;
+    }
+}// namespace Level
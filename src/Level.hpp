@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Component.hpp"
+#include "MappedFile.hpp"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Binary level format, in host byte order (files do not move between
+// little- and big-endian machines):
+//   Header
+//   wallCount Box entries
+//   paletteSize colors as RGBA bytes
+//   columns * rows palette indices, one byte per cell, row by row
+//   columns * rows hit points, one byte per cell, 0 for an empty cell
+// Bricks live on a grid of cellSize cells starting at origin; the cell
+// arrays can be copied straight into a BrickField.
+namespace Level {
+    inline constexpr std::uint32_t version = 1;
+
+    // Most cells a level may have. Keeps every cell index within 32 bits and
+    // rejects headers asking for far more memory than any real level needs.
+    inline constexpr std::uint64_t maxCells = std::uint64_t{1} << 26;
+
+    // Cells of a columns x rows grid, computed wide enough not to wrap.
+    [[nodiscard]] constexpr std::uint64_t getCellCount(std::uint32_t columns, std::uint32_t rows) {
+        return static_cast<std::uint64_t>(columns) * rows;
+    }
+
+    struct Box {
+        float x;
+        float y;
+        float width;
+        float height;
+    };
+    static_assert(sizeof(Box) == 16);
+
+    struct Header {
+        char magic[4];
+        std::uint32_t version;
+        Box goal;
+        Box paddle;
+        // Spawn box of every ball.
+        Box ball;
+        float paddleSpeed;
+        std::uint32_t wallCount;
+        std::uint32_t paletteSize;
+        std::uint32_t columns;
+        std::uint32_t rows;
+        float origin[2];
+        float cellSize[2];
+        std::uint32_t reserved;
+    };
+    static_assert(sizeof(Header) == 96);
+
+    // Editable form of a level, written by serialize().
+    struct Description {
+        Box goal;
+        Box paddle;
+        Box ball;
+        float paddleSpeed;
+        std::vector<Box> walls;
+        std::vector<std::array<std::uint8_t, 4>> palette;
+        std::uint32_t columns = 0;
+        std::uint32_t rows = 0;
+        glm::vec2 origin = glm::vec2(0.0f, 0.0f);
+        glm::vec2 cellSize = glm::vec2(1.0f, 1.0f);
+        std::vector<std::uint8_t> colors;
+        std::vector<std::uint8_t> hitPoints;
+    };
+
+    // The classic 800x600 field with rows x columns one-hit bricks colored by row.
+    Description makeDefault(std::uint32_t rows, std::uint32_t columns, glm::vec2 brickSize);
+
+    std::vector<std::uint8_t> serialize(const Description &description);
+
+    // Parses the text format described in the README. On failure returns
+    // nothing and describes the first error, with its line, in error.
+    std::optional<Description> parse(std::string_view text, std::string &error);
+
+    // Validated read-only view of a binary level, memory-mapped from a file or
+    // held in memory.
+    class File {
+    public:
+        bool open(const std::string &path);
+        bool load(std::vector<std::uint8_t> bytes);
+        void close();
+
+        [[nodiscard]] bool isOpen() const { return mData != nullptr; }
+        [[nodiscard]] const Header &getHeader() const { return mHeader; }
+
+        [[nodiscard]] Box getWall(std::uint32_t index) const;
+        [[nodiscard]] Component::Color getColor(std::uint8_t index) const;
+        [[nodiscard]] const std::uint8_t *getColors() const { return mColors; }
+        [[nodiscard]] const std::uint8_t *getHitPoints() const { return mHitPoints; }
+
+        // Cells with at least one hit point.
+        [[nodiscard]] std::uint32_t getBrickCount() const { return mBrickCount; }
+        // FNV-1a hash of the whole file, recorded by replays.
+        [[nodiscard]] std::uint32_t getHash() const { return mHash; }
+
+    private:
+        bool validate();
+
+        MappedFile mFile;
+        std::vector<std::uint8_t> mBytes;
+        const std::uint8_t *mData = nullptr;
+        std::size_t mSize = 0;
+        Header mHeader{};
+        const std::uint8_t *mWalls = nullptr;
+        const std::uint8_t *mPalette = nullptr;
+        const std::uint8_t *mColors = nullptr;
+        const std::uint8_t *mHitPoints = nullptr;
+        std::uint32_t mBrickCount = 0;
+        std::uint32_t mHash = 0;
+    };
+}// namespace Level
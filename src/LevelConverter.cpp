@@ -0,0 +1,48 @@
+#include "Level.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        std::fprintf(stderr,
+                     "Usage: %s <level.txt> <output.level>\n"
+                     "Converts a text level (see README) to the binary format loaded with --level.\n",
+                     argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::ifstream input(argv[1], std::ios::binary);
+    if (!input) {
+        std::fprintf(stderr, "Failed to open %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+    std::ostringstream text;
+    text << input.rdbuf();
+
+    std::string error;
+    const std::optional<Level::Description> description = Level::parse(text.str(), error);
+    if (!description) {
+        std::fprintf(stderr, "%s: %s\n", argv[1], error.c_str());
+        return EXIT_FAILURE;
+    }
+
+    const std::vector<std::uint8_t> bytes = Level::serialize(*description);
+    std::ofstream output(argv[2], std::ios::binary);
+    output.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!output) {
+        std::fprintf(stderr, "Failed to write %s\n", argv[2]);
+        return EXIT_FAILURE;
+    }
+
+    Level::File level;
+    if (!level.load(bytes)) {
+        std::fprintf(stderr, "Converted level does not validate\n");
+        return EXIT_FAILURE;
+    }
+    std::fprintf(stderr, "%s: %u x %u cells, %u bricks, %u walls, %u colors, %zu bytes\n", argv[2], description->columns, description->rows, level.getBrickCount(), level.getHeader().wallCount, level.getHeader().paletteSize, bytes.size());
+    return EXIT_SUCCESS;
+}
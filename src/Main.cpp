@@ -1,7 +1,63 @@
 #include "Application.hpp"
 
-int main() {
-    Application application;
+#include <cstdlib>
+#include <string_view>
+
+int main(int argc, char **argv) {
+    Application::Options options;
+    for (int index = 1; index < argc; ++index) {
+        const std::string_view argument = argv[index];
+        if (argument == "--tick-rate" && index + 1 < argc) {
+            options.tickRate = std::strtof(argv[++index], nullptr);
+        } else if (argument == "--record" && index + 1 < argc) {
+            options.recordPath = argv[++index];
+        } else if (argument == "--trace" && index + 1 < argc) {
+            options.tracePath = argv[++index];
+        } else if (argument == "--level" && index + 1 < argc) {
+            options.levelPath = argv[++index];
+        } else if (argument == "--dense-bricks") {
+            options.simulation.denseBricks = true;
+        } else if (argument == "--balls" && index + 1 < argc) {
+            options.simulation.balls = static_cast<std::uint32_t>(std::strtoul(argv[++index], nullptr, 10));
+        } else if (argument == "--multi-ball") {
+            options.simulation.multiBall = true;
+        } else if (argument == "--input-timestamps") {
+            options.inputTimestamps = true;
+        } else if (argument == "--software-renderer") {
+            options.softwareRenderer = true;
+        } else if (argument == "--max-catch-up" && index + 1 < argc) {
+            options.maxCatchUpSteps = static_cast<std::uint32_t>(std::strtoul(argv[++index], nullptr, 10));
+        } else if (argument == "--no-interpolation") {
+            options.interpolate = false;
+        } else if (argument == "--no-vsync") {
+            options.vsync = false;
+        } else if (argument == "--max-fps" && index + 1 < argc) {
+            options.maxFrameRate = std::strtof(argv[++index], nullptr);
+        } else if (argument == "--particles" && index + 1 < argc) {
+            options.particlesPerBrick = static_cast<std::uint32_t>(std::strtoul(argv[++index], nullptr, 10));
+        } else if (argument == "--max-particles" && index + 1 < argc) {
+            options.maxParticles = std::strtoull(argv[++index], nullptr, 10);
+        } else if (argument == "--memory-report") {
+            options.memoryReport = true;
+        } else {
+            SDL_Log("Unknown argument: %s", argv[index]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (options.tickRate <= 0.0f) {
+        SDL_Log("Tick rate must be positive");
+        return EXIT_FAILURE;
+    }
+    if (options.simulation.balls == 0) {
+        SDL_Log("At least one ball is needed");
+        return EXIT_FAILURE;
+    }
+    if (options.maxCatchUpSteps == 0) {
+        SDL_Log("At least one catch-up step is needed");
+        return EXIT_FAILURE;
+    }
+
+    Application application(options);
     application.run();
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,86 @@
+#include "MappedFile.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string &path, bool sequential) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    mFileHandle = file;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        close();
+        return false;
+    }
+    mSize = static_cast<std::size_t>(size.QuadPart);
+    mMappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mMappingHandle) {
+        close();
+        return false;
+    }
+    mData = static_cast<const std::uint8_t *>(MapViewOfFile(mMappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (!mData) {
+        close();
+        return false;
+    }
+#else
+    const int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        return false;
+    }
+    struct stat status {};
+    if (fstat(descriptor, &status) != 0 || status.st_size == 0) {
+        ::close(descriptor);
+        return false;
+    }
+    mSize = static_cast<std::size_t>(status.st_size);
+    void *data = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor);
+    if (data == MAP_FAILED) {
+        mSize = 0;
+        return false;
+    }
+    madvise(data, mSize, sequential ? MADV_SEQUENTIAL : MADV_WILLNEED);
+    mData = static_cast<const std::uint8_t *>(data);
+#endif
+    return true;
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+    if (mData) {
+        UnmapViewOfFile(mData);
+    }
+    if (mMappingHandle) {
+        CloseHandle(mMappingHandle);
+    }
+    if (mFileHandle) {
+        CloseHandle(mFileHandle);
+    }
+    mMappingHandle = nullptr;
+    mFileHandle = nullptr;
+#else
+    if (mData) {
+        munmap(const_cast<std::uint8_t *>(mData), mSize);
+    }
+#endif
+    mData = nullptr;
+    mSize = 0;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Read-only memory mapping of a whole file (mmap or MapViewOfFile).
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // Hints the kernel to read ahead when the file is consumed front to back.
+    bool open(const std::string &path, bool sequential = false);
+    void close();
+
+    [[nodiscard]] const std::uint8_t *getData() const { return mData; }
+    [[nodiscard]] std::size_t getSize() const { return mSize; }
+
+private:
+    const std::uint8_t *mData = nullptr;
+    std::size_t mSize = 0;
+#ifdef _WIN32
+    void *mFileHandle = nullptr;
+    void *mMappingHandle = nullptr;
+#endif
+};
@@ -0,0 +1,185 @@
+#include "Netplay.hpp"
+
+#include "Replay.hpp"
+#include "Serialize.hpp"
+
+#include <algorithm>
+#include <string_view>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace Netplay {
+    namespace {
+#ifdef _WIN32
+        using Handle = SOCKET;
+#else
+        using Handle = int;
+#endif
+
+        // Inputs per packet; a peer further behind catches up over several packets.
+        constexpr std::uint32_t maxInputsPerPacket = 64;
+        constexpr std::size_t maxPacketSize = 1024;
+
+        struct PacketHeader {
+            char magic[4];
+            std::uint32_t count;
+            // Tick of the first input in the packet.
+            std::uint64_t firstTick;
+            // Ticks of remote input the sender has confirmed.
+            std::uint64_t acknowledged;
+        };
+        static_assert(sizeof(PacketHeader) == 24);
+
+        sockaddr_in toSocketAddress(const Address &address) {
+            sockaddr_in socketAddress{};
+            socketAddress.sin_family = AF_INET;
+            socketAddress.sin_addr.s_addr = htonl(address.host);
+            socketAddress.sin_port = htons(address.port);
+            return socketAddress;
+        }
+    }// namespace
+
+    Socket::~Socket() {
+        close();
+    }
+
+    bool Socket::open(std::uint16_t port) {
+        close();
+
+#ifdef _WIN32
+        static const bool initialized = [] {
+            WSADATA data;
+            return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+        }();
+        if (!initialized) {
+            return false;
+        }
+        const Handle handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        if (handle == INVALID_SOCKET) {
+            return false;
+        }
+        mHandle = static_cast<std::intptr_t>(handle);
+        u_long nonBlocking = 1;
+        if (ioctlsocket(handle, FIONBIO, &nonBlocking) != 0) {
+            close();
+            return false;
+        }
+#else
+        const Handle handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        if (handle < 0) {
+            return false;
+        }
+        mHandle = handle;
+        if (fcntl(handle, F_SETFL, fcntl(handle, F_GETFL, 0) | O_NONBLOCK) != 0) {
+            close();
+            return false;
+        }
+#endif
+
+        sockaddr_in address = toSocketAddress(Address{INADDR_ANY, port});
+        socklen_t length = sizeof(address);
+        if (bind(static_cast<Handle>(mHandle), reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0 ||
+            getsockname(static_cast<Handle>(mHandle), reinterpret_cast<sockaddr *>(&address), &length) != 0) {
+            close();
+            return false;
+        }
+        mPort = ntohs(address.sin_port);
+        return true;
+    }
+
+    void Socket::close() {
+        if (mHandle != -1) {
+#ifdef _WIN32
+            closesocket(static_cast<Handle>(mHandle));
+#else
+            ::close(static_cast<Handle>(mHandle));
+#endif
+        }
+        mHandle = -1;
+        mPort = 0;
+    }
+
+    bool Socket::send(const Address &address, const std::uint8_t *data, std::size_t size) {
+        const sockaddr_in socketAddress = toSocketAddress(address);
+#ifdef _WIN32
+        const int sent = sendto(static_cast<Handle>(mHandle), reinterpret_cast<const char *>(data), static_cast<int>(size), 0, reinterpret_cast<const sockaddr *>(&socketAddress), sizeof(socketAddress));
+#else
+        const ssize_t sent = sendto(static_cast<Handle>(mHandle), data, size, 0, reinterpret_cast<const sockaddr *>(&socketAddress), sizeof(socketAddress));
+#endif
+        return sent >= 0 && static_cast<std::size_t>(sent) == size;
+    }
+
+    std::size_t Socket::receive(std::uint8_t *data, std::size_t capacity) {
+#ifdef _WIN32
+        const int received = recv(static_cast<Handle>(mHandle), reinterpret_cast<char *>(data), static_cast<int>(capacity), 0);
+#else
+        const ssize_t received = recv(static_cast<Handle>(mHandle), data, capacity, 0);
+#endif
+        return received > 0 ? static_cast<std::size_t>(received) : 0;
+    }
+
+    Peer::Peer(Rollback &rollback, Socket &socket, const Address &remote, const Conditions &conditions, std::uint32_t seed)
+        : mRollback(rollback), mSocket(socket), mRemote(remote), mConditions(conditions), mRandom(seed) {
+        mBuffer.resize(maxPacketSize);
+    }
+
+    void Peer::receive() {
+        while (const std::size_t size = mSocket.receive(mBuffer.data(), mBuffer.size())) {
+            Serialize::Reader reader(mBuffer.data(), size);
+            PacketHeader header{};
+            if (!reader.read(header) || std::string_view(header.magic, sizeof(header.magic)) != "BRKN" || header.count > maxInputsPerPacket) {
+                continue;
+            }
+            std::uint8_t inputs[maxInputsPerPacket];
+            if (!reader.readArray(inputs, header.count)) {
+                continue;
+            }
+            ++mStats.packetsReceived;
+            mAcknowledged = std::max(mAcknowledged, header.acknowledged);
+            // Inputs already confirmed are skipped by the rollback.
+            for (std::uint32_t index = 0; index < header.count; ++index) {
+                mRollback.receive(header.firstTick + index, Replay::decode(inputs[index]));
+            }
+        }
+    }
+
+    void Peer::advance(const Simulation::Input &input) {
+        mInputs.push_back(Replay::encode(input));
+        mRollback.advance(input);
+    }
+
+    void Peer::send(Clock::time_point now) {
+        const std::uint64_t first = std::min<std::uint64_t>(mAcknowledged, mInputs.size());
+        const PacketHeader header{{'B', 'R', 'K', 'N'}, static_cast<std::uint32_t>(std::min<std::uint64_t>(mInputs.size() - first, maxInputsPerPacket)), first, mRollback.getConfirmedTick()};
+        Packet packet{now, {}};
+        Serialize::write(packet.bytes, header);
+        Serialize::writeArray(packet.bytes, mInputs.data() + first, header.count);
+        ++mStats.packetsSent;
+
+        if (std::uniform_real_distribution<double>(0.0, 1.0)(mRandom) < mConditions.loss) {
+            ++mStats.packetsDropped;
+        } else {
+            const double delay = mConditions.delay + std::uniform_real_distribution<double>(-mConditions.jitter, mConditions.jitter)(mRandom);
+            packet.due += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(std::max(delay, 0.0)));
+            mDelayed.push_back(std::move(packet));
+        }
+
+        // Jitter can make a later packet due first, reordering them like a real network would.
+        const auto due = std::stable_partition(mDelayed.begin(), mDelayed.end(), [now](const Packet &delayed) { return delayed.due <= now; });
+        for (auto it = mDelayed.begin(); it != due; ++it) {
+            mSocket.send(mRemote, it->bytes.data(), it->bytes.size());
+        }
+        mDelayed.erase(mDelayed.begin(), due);
+    }
+}// namespace Netplay
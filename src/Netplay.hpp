@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Rollback.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Input exchange between two rollback peers over UDP. Every packet carries all
+// local inputs the remote has not acknowledged yet, so lost packets only cost
+// latency and nothing is ever resent on a timer.
+namespace Netplay {
+    // IPv4 address and port in host byte order.
+    struct Address {
+        std::uint32_t host;
+        std::uint16_t port;
+
+        static Address loopback(std::uint16_t port) { return Address{0x7F000001u, port}; }
+    };
+
+    // Non-blocking IPv4 UDP socket.
+    class Socket {
+    public:
+        Socket() = default;
+        ~Socket();
+
+        Socket(const Socket &) = delete;
+        Socket &operator=(const Socket &) = delete;
+
+        // Binds to port on every interface; 0 picks a free port.
+        bool open(std::uint16_t port);
+        void close();
+
+        [[nodiscard]] std::uint16_t getPort() const { return mPort; }
+
+        bool send(const Address &address, const std::uint8_t *data, std::size_t size);
+        // Size of the datagram copied into data, 0 when none is waiting.
+        std::size_t receive(std::uint8_t *data, std::size_t capacity);
+
+    private:
+        std::intptr_t mHandle = -1;
+        std::uint16_t mPort = 0;
+    };
+
+    // Conditions applied to outgoing packets, to test on localhost.
+    struct Conditions {
+        // Added to every packet, plus or minus a uniform jitter, in seconds.
+        double delay = 0.0;
+        double jitter = 0.0;
+        // Probability of dropping a packet.
+        double loss = 0.0;
+    };
+
+    class Peer {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        struct Stats {
+            std::uint64_t packetsSent = 0;
+            std::uint64_t packetsDropped = 0;
+            std::uint64_t packetsReceived = 0;
+        };
+
+        Peer(Rollback &rollback, Socket &socket, const Address &remote, const Conditions &conditions, std::uint32_t seed);
+
+        // Feeds the remote inputs of every packet received so far to the rollback.
+        void receive();
+        // Runs the next tick with the local input. Only call while the rollback canAdvance().
+        void advance(const Simulation::Input &input);
+        // Sends the unacknowledged inputs and every delayed packet that is due by now.
+        void send(Clock::time_point now);
+
+        // Encoded local input of every tick so far.
+        [[nodiscard]] const std::vector<std::uint8_t> &getInputs() const { return mInputs; }
+        [[nodiscard]] const Stats &getStats() const { return mStats; }
+
+    private:
+        struct Packet {
+            Clock::time_point due;
+            std::vector<std::uint8_t> bytes;
+        };
+
+        Rollback &mRollback;
+        Socket &mSocket;
+        Address mRemote;
+        Conditions mConditions;
+        std::mt19937 mRandom;
+        std::vector<std::uint8_t> mInputs;
+        // Ticks of local input the remote has confirmed.
+        std::uint64_t mAcknowledged = 0;
+        std::vector<Packet> mDelayed;
+        std::vector<std::uint8_t> mBuffer;
+        Stats mStats;
+    };
+}// namespace Netplay
@@ -0,0 +1,202 @@
+#include "Netplay.hpp"
+#include "Replay.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <random>
+#include <string_view>
+#include <thread>
+
+namespace {
+    struct Options {
+        std::uint64_t ticks = 2400;
+        float tickRate = 240.0f;
+        std::uint32_t seed = 1;
+        std::uint16_t port = 0;
+        Netplay::Conditions conditions{0.05, 0.01, 0.05};
+        Simulation::Config config;
+        std::string levelPath;
+        bool realtime = false;
+    };
+
+    // Holds a random direction (or none) for a random number of ticks.
+    class RandomInput {
+    public:
+        explicit RandomInput(std::uint32_t seed) : mRandom(seed) {}
+
+        Simulation::Input operator()() {
+            if (mHold == 0) {
+                const int choice = std::uniform_int_distribution<int>(0, 2)(mRandom);
+                mInput.left = choice == 1;
+                mInput.right = choice == 2;
+                mHold = std::uniform_int_distribution<std::uint32_t>(1, 120)(mRandom);
+            }
+            --mHold;
+            return mInput;
+        }
+
+    private:
+        std::mt19937 mRandom;
+        Simulation::Input mInput;
+        std::uint32_t mHold = 0;
+    };
+
+    // One player: a simulation driven by a rollback fed from its own socket.
+    struct Player {
+        Player(const Options &options, const Level::File *level, std::uint32_t seed)
+            : simulation(options.config, level), rollback((simulation.reset(), simulation), 1.0f / options.tickRate), input(seed) {}
+
+        Simulation simulation;
+        Rollback rollback;
+        Netplay::Socket socket;
+        std::optional<Netplay::Peer> peer;
+        RandomInput input;
+    };
+
+    void printUsage(const char *program) {
+        std::fprintf(stderr,
+                     "Usage: %s [options]\n"
+                     "Plays two rollback peers against each other over UDP on localhost and\n"
+                     "checks that both end in the same state as a game without rollback.\n"
+                     "  --ticks N        ticks to play (default 2400)\n"
+                     "  --tick-rate HZ   fixed update rate (default 240)\n"
+                     "  --delay MS       one-way packet delay (default 50)\n"
+                     "  --jitter MS      random delay added or removed (default 10)\n"
+                     "  --loss PERCENT   packets dropped (default 5)\n"
+                     "  --seed N         seed of the inputs and network conditions (default 1)\n"
+                     "  --port N         first of the two ports to bind (default: any free)\n"
+                     "  --balls N        balls per game (default 1)\n"
+                     "  --level FILE     play a binary level instead of the built-in one\n"
+                     "  --dense-bricks   keep bricks in a bitset grid instead of entities\n"
+                     "  --realtime       pace ticks to the wall clock instead of running flat out\n",
+                     program);
+    }
+
+    bool parseOptions(int argc, char **argv, Options &options) {
+        for (int index = 1; index < argc; ++index) {
+            const std::string_view argument = argv[index];
+            const char *value = index + 1 < argc ? argv[index + 1] : nullptr;
+            if (argument == "--realtime") {
+                options.realtime = true;
+                continue;
+            }
+            if (argument == "--dense-bricks") {
+                options.config.denseBricks = true;
+                continue;
+            }
+            if (!value) {
+                return false;
+            }
+            ++index;
+            if (argument == "--ticks") {
+                options.ticks = std::strtoull(value, nullptr, 10);
+            } else if (argument == "--tick-rate") {
+                options.tickRate = std::strtof(value, nullptr);
+            } else if (argument == "--delay") {
+                options.conditions.delay = std::strtod(value, nullptr) / 1000.0;
+            } else if (argument == "--jitter") {
+                options.conditions.jitter = std::strtod(value, nullptr) / 1000.0;
+            } else if (argument == "--loss") {
+                options.conditions.loss = std::strtod(value, nullptr) / 100.0;
+            } else if (argument == "--seed") {
+                options.seed = static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10));
+            } else if (argument == "--port") {
+                options.port = static_cast<std::uint16_t>(std::strtoul(value, nullptr, 10));
+            } else if (argument == "--balls") {
+                options.config.balls = static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10));
+            } else if (argument == "--level") {
+                options.levelPath = value;
+            } else {
+                return false;
+            }
+        }
+        return options.tickRate > 0.0f && options.config.balls > 0;
+    }
+
+    void printPlayer(const char *name, const Player &player, double fixedStep) {
+        const Rollback::Stats &rollback = player.rollback.getStats();
+        const Netplay::Peer::Stats &peer = player.peer->getStats();
+        const double average = rollback.rollbacks > 0 ? rollback.totalSeconds / static_cast<double>(rollback.rollbacks) : 0.0;
+        std::printf("%s: %llu packets sent (%llu dropped), %llu received; %llu rollbacks, %llu ticks re-simulated, deepest %u ticks\n", name,
+                    static_cast<unsigned long long>(peer.packetsSent), static_cast<unsigned long long>(peer.packetsDropped), static_cast<unsigned long long>(peer.packetsReceived),
+                    static_cast<unsigned long long>(rollback.rollbacks), static_cast<unsigned long long>(rollback.resimulatedTicks), rollback.maxDepth);
+        std::printf("%s: rollback average %.3f ms, longest %.3f ms (%.1f%% of a fixed step)\n", name, average * 1000.0, rollback.maxSeconds * 1000.0, 100.0 * rollback.maxSeconds / fixedStep);
+    }
+}// namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    Level::File level;
+    if (!options.levelPath.empty() && !level.open(options.levelPath)) {
+        std::fprintf(stderr, "Failed to open level %s\n", options.levelPath.c_str());
+        return EXIT_FAILURE;
+    }
+    const Level::File *levelFile = level.isOpen() ? &level : nullptr;
+
+    Player first(options, levelFile, options.seed);
+    Player second(options, levelFile, options.seed + 1);
+    if (!first.socket.open(options.port) || !second.socket.open(options.port != 0 ? options.port + 1 : 0)) {
+        std::fprintf(stderr, "Failed to open UDP sockets\n");
+        return EXIT_FAILURE;
+    }
+    first.peer.emplace(first.rollback, first.socket, Netplay::Address::loopback(second.socket.getPort()), options.conditions, options.seed * 2);
+    second.peer.emplace(second.rollback, second.socket, Netplay::Address::loopback(first.socket.getPort()), options.conditions, options.seed * 2 + 1);
+
+    // Time only drives the simulated network conditions, so without --realtime
+    // it advances one fixed step per loop without waiting for the clock.
+    using Clock = Netplay::Peer::Clock;
+    const auto tickDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / options.tickRate));
+    const Clock::time_point start = Clock::now();
+    Clock::time_point now = start;
+    const std::uint64_t maxLoops = options.ticks * 100 + 10000;
+    std::uint64_t loops = 0;
+    for (; loops < maxLoops; ++loops) {
+        bool finished = true;
+        for (Player *player: {&first, &second}) {
+            player->peer->receive();
+            if (player->rollback.getTick() < options.ticks && player->rollback.canAdvance()) {
+                player->peer->advance(player->input());
+            }
+            player->peer->send(now);
+            finished = finished && player->rollback.getTick() == options.ticks && player->rollback.getConfirmedTick() >= options.ticks;
+        }
+        if (finished) {
+            break;
+        }
+        now += tickDuration;
+        if (options.realtime) {
+            std::this_thread::sleep_until(now);
+        }
+    }
+    first.rollback.synchronize();
+    second.rollback.synchronize();
+
+    // The same inputs without any network in between.
+    Simulation reference(options.config, levelFile);
+    reference.reset();
+    const float fixedDeltaTime = 1.0f / options.tickRate;
+    const std::uint64_t played = std::min(first.peer->getInputs().size(), second.peer->getInputs().size());
+    for (std::uint64_t tick = 0; tick < played; ++tick) {
+        reference.fixedUpdate(fixedDeltaTime, Rollback::combine(Replay::decode(first.peer->getInputs()[tick]), Replay::decode(second.peer->getInputs()[tick])));
+        reference.update();
+    }
+
+    const bool complete = loops < maxLoops;
+    const std::uint64_t hashes[] = {first.simulation.getStateHash(), second.simulation.getStateHash(), reference.getStateHash()};
+    const bool matched = complete && hashes[0] == hashes[2] && hashes[1] == hashes[2];
+
+    std::printf("ticks: %llu in %llu loops, delay %.0f ms +- %.0f ms, loss %.0f%%\n", static_cast<unsigned long long>(played), static_cast<unsigned long long>(loops),
+                options.conditions.delay * 1000.0, options.conditions.jitter * 1000.0, options.conditions.loss * 100.0);
+    printPlayer("player 1", first, 1.0 / options.tickRate);
+    printPlayer("player 2", second, 1.0 / options.tickRate);
+    std::printf("state: player 1 %016llx, player 2 %016llx, reference %016llx: %s\n", static_cast<unsigned long long>(hashes[0]), static_cast<unsigned long long>(hashes[1]),
+                static_cast<unsigned long long>(hashes[2]), matched ? "in sync" : complete ? "DESYNC" : "INCOMPLETE");
+    return matched ? EXIT_SUCCESS : EXIT_FAILURE;
+}
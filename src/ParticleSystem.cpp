@@ -0,0 +1,181 @@
+#include "ParticleSystem.hpp"
+
+#include <glm/gtc/constants.hpp>
+
+#include <algorithm>
+#include <bit>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#define BREAKOUT_PARTICLES_AVX2
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BREAKOUT_PARTICLES_SSE2
+#endif
+#endif
+
+#if defined(__GNUC__)
+#define BREAKOUT_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define BREAKOUT_TARGET_AVX2
+#endif
+
+namespace {
+    // Lanes of the widest kernel; arrays are padded to a multiple of it so
+    // the kernels never need a scalar tail. Padding lanes are integrated
+    // along with the rest and simply never read.
+    constexpr std::size_t lanes = 8;
+
+    std::size_t roundUp(std::size_t count) {
+        return (count + lanes - 1) / lanes * lanes;
+    }
+
+    struct Arrays {
+        float *x;
+        float *y;
+        float *velocityX;
+        float *velocityY;
+        float *life;
+    };
+
+    // Semi-implicit Euler: velocity first, then position with the new velocity.
+    void integrateScalar(const Arrays &arrays, std::size_t begin, std::size_t end, glm::vec2 gravity, float deltaTime) {
+        for (std::size_t index = begin; index < end; ++index) {
+            arrays.velocityX[index] += gravity.x * deltaTime;
+            arrays.velocityY[index] += gravity.y * deltaTime;
+            arrays.x[index] += arrays.velocityX[index] * deltaTime;
+            arrays.y[index] += arrays.velocityY[index] * deltaTime;
+            arrays.life[index] -= deltaTime;
+        }
+    }
+
+#if defined(BREAKOUT_PARTICLES_SSE2)
+    void integrateSSE2(const Arrays &arrays, std::size_t begin, std::size_t end, glm::vec2 gravity, float deltaTime) {
+        const __m128 deltaTimes = _mm_set1_ps(deltaTime);
+        const __m128 gravityX = _mm_set1_ps(gravity.x * deltaTime);
+        const __m128 gravityY = _mm_set1_ps(gravity.y * deltaTime);
+        for (std::size_t index = begin; index < end; index += 4) {
+            const __m128 velocityX = _mm_add_ps(_mm_loadu_ps(arrays.velocityX + index), gravityX);
+            const __m128 velocityY = _mm_add_ps(_mm_loadu_ps(arrays.velocityY + index), gravityY);
+            _mm_storeu_ps(arrays.velocityX + index, velocityX);
+            _mm_storeu_ps(arrays.velocityY + index, velocityY);
+            _mm_storeu_ps(arrays.x + index, _mm_add_ps(_mm_loadu_ps(arrays.x + index), _mm_mul_ps(velocityX, deltaTimes)));
+            _mm_storeu_ps(arrays.y + index, _mm_add_ps(_mm_loadu_ps(arrays.y + index), _mm_mul_ps(velocityY, deltaTimes)));
+            _mm_storeu_ps(arrays.life + index, _mm_sub_ps(_mm_loadu_ps(arrays.life + index), deltaTimes));
+        }
+    }
+#endif
+
+#if defined(BREAKOUT_PARTICLES_AVX2)
+    BREAKOUT_TARGET_AVX2 void integrateAVX2(const Arrays &arrays, std::size_t begin, std::size_t end, glm::vec2 gravity, float deltaTime) {
+        const __m256 deltaTimes = _mm256_set1_ps(deltaTime);
+        const __m256 gravityX = _mm256_set1_ps(gravity.x * deltaTime);
+        const __m256 gravityY = _mm256_set1_ps(gravity.y * deltaTime);
+        for (std::size_t index = begin; index < end; index += 8) {
+            const __m256 velocityX = _mm256_add_ps(_mm256_loadu_ps(arrays.velocityX + index), gravityX);
+            const __m256 velocityY = _mm256_add_ps(_mm256_loadu_ps(arrays.velocityY + index), gravityY);
+            _mm256_storeu_ps(arrays.velocityX + index, velocityX);
+            _mm256_storeu_ps(arrays.velocityY + index, velocityY);
+            _mm256_storeu_ps(arrays.x + index, _mm256_add_ps(_mm256_loadu_ps(arrays.x + index), _mm256_mul_ps(velocityX, deltaTimes)));
+            _mm256_storeu_ps(arrays.y + index, _mm256_add_ps(_mm256_loadu_ps(arrays.y + index), _mm256_mul_ps(velocityY, deltaTimes)));
+            _mm256_storeu_ps(arrays.life + index, _mm256_sub_ps(_mm256_loadu_ps(arrays.life + index), deltaTimes));
+        }
+    }
+#endif
+}// namespace
+
+ParticleSystem::ParticleSystem(const Config &config, Collision::InstructionSet instructionSet) : mConfig(config), mInstructionSet(instructionSet), mRandom(1) {
+    const std::size_t padded = roundUp(config.capacity);
+    mX.assign(padded, 0.0f);
+    mY.assign(padded, 0.0f);
+    mVelocityX.assign(padded, 0.0f);
+    mVelocityY.assign(padded, 0.0f);
+    mLife.assign(padded, 0.0f);
+    mInverseLifetime.assign(padded, 0.0f);
+    mColors.assign(padded, 0);
+}
+
+void ParticleSystem::emit(glm::vec2 position, glm::vec2 size, std::uint32_t color, std::uint32_t count) {
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    const std::size_t emitted = std::min<std::size_t>(count, mConfig.capacity - mSize);
+    for (std::size_t particle = 0; particle < emitted; ++particle, ++mSize) {
+        // Mostly upwards, so debris arcs over before gravity takes it down.
+        const float angle = unit(mRandom) * glm::two_pi<float>();
+        const float speed = 60.0f + 180.0f * unit(mRandom);
+        const float lifetime = 0.4f + 0.6f * unit(mRandom);
+        mX[mSize] = position.x + unit(mRandom) * size.x;
+        mY[mSize] = position.y + unit(mRandom) * size.y;
+        mVelocityX[mSize] = glm::cos(angle) * speed;
+        mVelocityY[mSize] = glm::sin(angle) * speed - 120.0f;
+        mLife[mSize] = lifetime;
+        mInverseLifetime[mSize] = 1.0f / lifetime;
+        mColors[mSize] = color;
+    }
+}
+
+void ParticleSystem::update(float deltaTime, ThreadPool *threadPool) {
+    const std::size_t end = roundUp(mSize);
+    if (threadPool && mSize >= mConfig.parallelThreshold) {
+        // Blocks of whole lanes, a few per thread so early finishers can steal.
+        const std::size_t blocks = end / lanes;
+        const std::size_t grainSize = std::max<std::size_t>(blocks / (threadPool->getThreadCount() * 4), 1);
+        threadPool->parallelFor(blocks, grainSize, [&](std::size_t begin, std::size_t last) {
+            integrate(begin * lanes, last * lanes, deltaTime);
+        });
+    } else {
+        integrate(0, end, deltaTime);
+    }
+    removeExpired();
+}
+
+void ParticleSystem::copyTo(std::vector<float> &x, std::vector<float> &y, std::vector<std::uint32_t> &colors) const {
+    x.assign(mX.begin(), mX.begin() + static_cast<std::ptrdiff_t>(mSize));
+    y.assign(mY.begin(), mY.begin() + static_cast<std::ptrdiff_t>(mSize));
+    colors.resize(mSize);
+    // Scales red, green and blue by fade / 256 two bytes per multiply and
+    // keeps alpha, the last byte in memory.
+    constexpr std::uint32_t alphaMask = std::endian::native == std::endian::little ? 0xFF000000u : 0x000000FFu;
+    for (std::size_t index = 0; index < mSize; ++index) {
+        const auto fade = static_cast<std::uint32_t>(std::clamp(mLife[index] * mInverseLifetime[index], 0.0f, 1.0f) * 256.0f);
+        const std::uint32_t color = mColors[index];
+        const std::uint32_t evenBytes = (((color & 0x00FF00FFu) * fade) >> 8) & 0x00FF00FFu;
+        const std::uint32_t oddBytes = (((color >> 8) & 0x00FF00FFu) * fade) & 0xFF00FF00u;
+        colors[index] = ((evenBytes | oddBytes) & ~alphaMask) | (color & alphaMask);
+    }
+}
+
+void ParticleSystem::integrate(std::size_t begin, std::size_t end, float deltaTime) {
+    const Arrays arrays{mX.data(), mY.data(), mVelocityX.data(), mVelocityY.data(), mLife.data()};
+    switch (mInstructionSet) {
+#if defined(BREAKOUT_PARTICLES_AVX2)
+        case Collision::InstructionSet::AVX2:
+            integrateAVX2(arrays, begin, end, mConfig.gravity, deltaTime);
+            break;
+#endif
+#if defined(BREAKOUT_PARTICLES_SSE2)
+        case Collision::InstructionSet::SSE2:
+            integrateSSE2(arrays, begin, end, mConfig.gravity, deltaTime);
+            break;
+#endif
+        default:
+            integrateScalar(arrays, begin, end, mConfig.gravity, deltaTime);
+            break;
+    }
+}
+
+void ParticleSystem::removeExpired() {
+    // Order does not matter, so an expired particle is replaced by the last one.
+    for (std::size_t index = 0; index < mSize;) {
+        if (mLife[index] > 0.0f) {
+            ++index;
+            continue;
+        }
+        --mSize;
+        mX[index] = mX[mSize];
+        mY[index] = mY[mSize];
+        mVelocityX[index] = mVelocityX[mSize];
+        mVelocityY[index] = mVelocityY[mSize];
+        mLife[index] = mLife[mSize];
+        mInverseLifetime[index] = mInverseLifetime[mSize];
+        mColors[index] = mColors[mSize];
+    }
+}
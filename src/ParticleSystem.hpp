@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Collision.hpp"
+#include "ThreadPool.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Short-lived debris kept out of the registry in a fixed-capacity pool laid
+// out as structure of arrays: one array per attribute, so integration runs
+// eight particles per AVX2 instruction and nothing is allocated after
+// construction. Particles are purely visual: they are never saved, hashed or
+// collided with.
+class ParticleSystem {
+public:
+    struct Config {
+        // Emission beyond this many live particles is dropped.
+        std::size_t capacity = 100000;
+        glm::vec2 gravity = glm::vec2(0.0f, 600.0f);
+        // Live particles from which update() splits the integration over the thread pool.
+        std::size_t parallelThreshold = 32768;
+    };
+
+    explicit ParticleSystem(const Config &config, Collision::InstructionSet instructionSet = Collision::getInstructionSet());
+
+    // Sprays count particles of color (RGBA bytes in memory order) from
+    // random points of the box.
+    void emit(glm::vec2 position, glm::vec2 size, std::uint32_t color, std::uint32_t count);
+    // Moves every particle and removes the expired ones. threadPool may be null.
+    void update(float deltaTime, ThreadPool *threadPool = nullptr);
+    void clear() { mSize = 0; }
+
+    [[nodiscard]] std::size_t size() const { return mSize; }
+    [[nodiscard]] std::size_t capacity() const { return mConfig.capacity; }
+    [[nodiscard]] const float *getX() const { return mX.data(); }
+    [[nodiscard]] const float *getY() const { return mY.data(); }
+
+    // Copies the positions of the live particles and their colors faded
+    // towards black over their lifetime, e.g. into a render snapshot.
+    void copyTo(std::vector<float> &x, std::vector<float> &y, std::vector<std::uint32_t> &colors) const;
+
+private:
+    // Integrates particles [begin, end); both are multiples of the lane count.
+    void integrate(std::size_t begin, std::size_t end, float deltaTime);
+    void removeExpired();
+
+    Config mConfig;
+    Collision::InstructionSet mInstructionSet;
+    std::size_t mSize = 0;
+    std::vector<float> mX;
+    std::vector<float> mY;
+    std::vector<float> mVelocityX;
+    std::vector<float> mVelocityY;
+    // Seconds left to live, and one over the whole lifetime for fading.
+    std::vector<float> mLife;
+    std::vector<float> mInverseLifetime;
+    std::vector<std::uint32_t> mColors;
+    std::minstd_rand mRandom;
+};
@@ -0,0 +1,109 @@
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+Profiler::Profiler() : mEpoch(Clock::now()) {}
+
+void Profiler::record(const char *name, Clock::time_point start, Clock::time_point end) {
+    const double milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+
+    std::lock_guard lock(mMutex);
+    Section &section = getSection(name, false);
+    section.samples[section.next] = milliseconds;
+    section.next = (section.next + 1) % samplesPerSection;
+    section.size = std::min(section.size + 1, samplesPerSection);
+
+    if (mTracing && mTraceEvents.size() < maxTraceEvents) {
+        const auto startMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(start - mEpoch).count();
+        const auto durationMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        mTraceEvents.push_back(TraceEvent{name, false, getThreadId(), startMicroseconds, durationMicroseconds, 0.0});
+    }
+}
+
+void Profiler::count(const char *name, double value) {
+    std::lock_guard lock(mMutex);
+    Section &section = getSection(name, true);
+    section.samples[section.next] = value;
+    section.next = (section.next + 1) % samplesPerSection;
+    section.size = std::min(section.size + 1, samplesPerSection);
+
+    if (mTracing && mTraceEvents.size() < maxTraceEvents) {
+        const auto nowMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - mEpoch).count();
+        mTraceEvents.push_back(TraceEvent{name, true, getThreadId(), nowMicroseconds, 0, value});
+    }
+}
+
+std::vector<Profiler::Stats> Profiler::getStats() const {
+    std::lock_guard lock(mMutex);
+    std::vector<Stats> stats;
+    std::vector<double> sorted;
+    for (const Section &section: mSections) {
+        if (section.size == 0) {
+            continue;
+        }
+        sorted.assign(section.samples.begin(), section.samples.begin() + static_cast<std::ptrdiff_t>(section.size));
+        std::sort(sorted.begin(), sorted.end());
+
+        double sum = 0.0;
+        for (const double sample: sorted) {
+            sum += sample;
+        }
+        const std::size_t last = (section.next + samplesPerSection - 1) % samplesPerSection;
+        const std::size_t p99 = std::min(sorted.size() - 1, sorted.size() * 99 / 100);
+        stats.push_back(Stats{section.name, section.counter, section.samples[last], sorted.front(), sum / static_cast<double>(sorted.size()), sorted[p99], sorted.back()});
+    }
+    return stats;
+}
+
+void Profiler::beginTrace() {
+    std::lock_guard lock(mMutex);
+    mTraceEvents.clear();
+    mTracing = true;
+}
+
+bool Profiler::endTrace(const std::string &path) {
+    std::vector<TraceEvent> events;
+    {
+        std::lock_guard lock(mMutex);
+        mTracing = false;
+        events.swap(mTraceEvents);
+    }
+
+    std::ofstream stream(path, std::ios::trunc);
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (std::size_t index = 0; index < events.size(); ++index) {
+        const TraceEvent &event = events[index];
+        stream << (index > 0 ? ",\n" : "\n") << "{\"name\":\"" << event.name << "\",\"pid\":0,\"tid\":" << event.thread << ",\"ts\":" << event.start;
+        if (event.counter) {
+            stream << ",\"ph\":\"C\",\"args\":{\"value\":" << event.value << "}}";
+        } else {
+            stream << ",\"ph\":\"X\",\"dur\":" << event.duration << "}";
+        }
+    }
+    stream << "\n]}\n";
+    return static_cast<bool>(stream);
+}
+
+Profiler::Section &Profiler::getSection(const char *name, bool counter) {
+    // Names are literals, so comparing pointers finds the section without touching the strings.
+    for (Section &section: mSections) {
+        if (section.name == name) {
+            return section;
+        }
+    }
+    for (Section &section: mSections) {
+        if (std::strcmp(section.name, name) == 0) {
+            return section;
+        }
+    }
+    mSections.push_back(Section{name, counter, 0, 0, {}});
+    return mSections.back();
+}
+
+std::uint32_t Profiler::getThreadId() {
+    return static_cast<std::uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+}
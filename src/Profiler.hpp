@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Collects timings of named sections into rolling windows and, while a trace
+// is being captured, into Chrome trace_event records (chrome://tracing or
+// https://ui.perfetto.dev). Names must be string literals.
+class Profiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    class Scope {
+    public:
+        Scope(Profiler *profiler, const char *name) : mProfiler(profiler), mName(name) {
+            if (mProfiler) {
+                mStart = Clock::now();
+            }
+        }
+
+        ~Scope() {
+            if (mProfiler) {
+                mProfiler->record(mName, mStart, Clock::now());
+            }
+        }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        Profiler *mProfiler;
+        const char *mName;
+        Clock::time_point mStart;
+    };
+
+    struct Stats {
+        const char *name;
+        bool counter;
+        double last;
+        double min;
+        double average;
+        double p99;
+        double max;
+    };
+
+    Profiler();
+
+    void record(const char *name, Clock::time_point start, Clock::time_point end);
+    void count(const char *name, double value);
+
+    // Statistics over the last samplesPerSection samples of every section, in
+    // milliseconds for timers, in first-recorded order.
+    [[nodiscard]] std::vector<Stats> getStats() const;
+
+    void beginTrace();
+    bool endTrace(const std::string &path);
+    [[nodiscard]] bool isTracing() const { return mTracing; }
+
+private:
+    static constexpr std::size_t samplesPerSection = 256;
+    static constexpr std::size_t maxTraceEvents = 1u << 22u;
+
+    struct Section {
+        const char *name;
+        bool counter;
+        std::size_t next;
+        std::size_t size;
+        std::array<double, samplesPerSection> samples;
+    };
+
+    struct TraceEvent {
+        const char *name;
+        bool counter;
+        std::uint32_t thread;
+        std::int64_t start;
+        std::int64_t duration;
+        double value;
+    };
+
+    Section &getSection(const char *name, bool counter);
+    static std::uint32_t getThreadId();
+
+    mutable std::mutex mMutex;
+    Clock::time_point mEpoch;
+    std::vector<Section> mSections;
+    std::vector<TraceEvent> mTraceEvents;
+    bool mTracing = false;
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <entt/entt.hpp>
+
+#include <algorithm>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+// Copy of the entities and listed components of a registry, restored wholesale
+// into it later. Restoring recreates the captured entities under their
+// original ids and refills every storage in its captured order, so views
+// iterate exactly as they did at capture time and storages keep the capacity
+// they already have.
+template<typename... Components>
+class Prototype {
+public:
+    void capture(entt::registry &registry) {
+        mEntities.clear();
+        (capturePool<Components>(registry), ...);
+        std::sort(mEntities.begin(), mEntities.end());
+        mEntities.erase(std::unique(mEntities.begin(), mEntities.end()), mEntities.end());
+        mCaptured = true;
+    }
+
+    // Destroys every entity of the registry first, captured or not.
+    void restore(entt::registry &registry) const {
+        registry.clear();
+        for (const entt::entity entity: mEntities) {
+            registry.create(entity);
+        }
+        (restorePool<Components>(registry), ...);
+    }
+
+    [[nodiscard]] bool isCaptured() const { return mCaptured; }
+
+private:
+    template<typename Component>
+    struct Pool {
+        // Packed order of the storage.
+        std::vector<entt::entity> entities;
+        std::vector<Component> components;
+    };
+
+    template<typename Component>
+    void capturePool(entt::registry &registry) {
+        Pool<Component> &pool = std::get<Pool<Component>>(mPools);
+        const auto &storage = registry.storage<Component>();
+        pool.entities.assign(storage.data(), storage.data() + storage.size());
+        pool.components.clear();
+        if constexpr (!std::is_empty_v<Component>) {
+            pool.components.reserve(pool.entities.size());
+            for (const entt::entity entity: pool.entities) {
+                pool.components.push_back(storage.get(entity));
+            }
+        }
+        mEntities.insert(mEntities.end(), pool.entities.begin(), pool.entities.end());
+    }
+
+    template<typename Component>
+    void restorePool(entt::registry &registry) const {
+        const Pool<Component> &pool = std::get<Pool<Component>>(mPools);
+        if constexpr (std::is_empty_v<Component>) {
+            registry.insert<Component>(pool.entities.begin(), pool.entities.end());
+        } else {
+            registry.insert<Component>(pool.entities.begin(), pool.entities.end(), pool.components.begin());
+        }
+    }
+
+    std::tuple<Pool<Components>...> mPools;
+    std::vector<entt::entity> mEntities;
+    bool mCaptured = false;
+};
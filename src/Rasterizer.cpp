@@ -0,0 +1,128 @@
+#include "Rasterizer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#define BREAKOUT_RASTERIZER_AVX2
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BREAKOUT_RASTERIZER_SSE2
+#endif
+#endif
+
+#if defined(__GNUC__)
+#define BREAKOUT_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define BREAKOUT_TARGET_AVX2
+#endif
+
+namespace {
+    // Each fill writes count pixels of pattern, which is one RGBA8 pixel
+    // or four Gray8 pixels, so both formats share the same kernels.
+    void fillRowScalar(std::uint8_t *row, std::size_t bytes, std::uint32_t pattern) {
+        std::size_t offset = 0;
+        for (; offset + 4 <= bytes; offset += 4) {
+            std::memcpy(row + offset, &pattern, 4);
+        }
+        std::memcpy(row + offset, &pattern, bytes - offset);
+    }
+
+#if defined(BREAKOUT_RASTERIZER_SSE2)
+    void fillRowSSE2(std::uint8_t *row, std::size_t bytes, std::uint32_t pattern) {
+        const __m128i value = _mm_set1_epi32(static_cast<int>(pattern));
+        std::size_t offset = 0;
+        for (; offset + 16 <= bytes; offset += 16) {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(row + offset), value);
+        }
+        fillRowScalar(row + offset, bytes - offset, pattern);
+    }
+#endif
+
+#if defined(BREAKOUT_RASTERIZER_AVX2)
+    BREAKOUT_TARGET_AVX2 void fillRowAVX2(std::uint8_t *row, std::size_t bytes, std::uint32_t pattern) {
+        const __m256i value = _mm256_set1_epi32(static_cast<int>(pattern));
+        std::size_t offset = 0;
+        for (; offset + 32 <= bytes; offset += 32) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(row + offset), value);
+        }
+        if (offset + 16 <= bytes) {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(row + offset), _mm256_castsi256_si128(value));
+            offset += 16;
+        }
+        fillRowScalar(row + offset, bytes - offset, pattern);
+    }
+#endif
+
+    // The pattern of one color in memory order, repeated to fill four bytes.
+    std::uint32_t toPattern(Rasterizer::Color color, Rasterizer::Format format) {
+        std::uint8_t bytes[4] = {color.r, color.g, color.b, color.a};
+        if (format == Rasterizer::Format::Gray8) {
+            const auto luma = static_cast<std::uint8_t>((77u * color.r + 150u * color.g + 29u * color.b + 128u) >> 8);
+            std::memset(bytes, luma, sizeof(bytes));
+        }
+        std::uint32_t pattern = 0;
+        std::memcpy(&pattern, bytes, sizeof(pattern));
+        return pattern;
+    }
+}// namespace
+
+void Rasterizer::setTarget(std::uint8_t *pixels, int width, int height, std::ptrdiff_t pitch, Format format) {
+    mPixels = pixels;
+    mWidth = width;
+    mHeight = height;
+    mPitch = pitch;
+    mFormat = format;
+}
+
+void Rasterizer::clear(Color color) {
+    fillRect(Rect{0, 0, mWidth, mHeight}, color);
+}
+
+void Rasterizer::fillRect(const Rect &rect, Color color) {
+    const int minX = std::max(rect.x, 0);
+    const int minY = std::max(rect.y, 0);
+    const int maxX = std::min(rect.x + rect.w, mWidth);
+    const int maxY = std::min(rect.y + rect.h, mHeight);
+    if (minX >= maxX || minY >= maxY) {
+        return;
+    }
+
+    const std::size_t bytesPerPixel = getBytesPerPixel(mFormat);
+    const std::size_t bytes = static_cast<std::size_t>(maxX - minX) * bytesPerPixel;
+    const std::uint32_t pattern = toPattern(color, mFormat);
+    std::uint8_t *row = mPixels + minY * mPitch + static_cast<std::ptrdiff_t>(static_cast<std::size_t>(minX) * bytesPerPixel);
+    auto fillRows = [&](auto fillRow) {
+        for (int y = minY; y < maxY; ++y, row += mPitch) {
+            fillRow(row, bytes, pattern);
+        }
+    };
+    switch (mInstructionSet) {
+#if defined(BREAKOUT_RASTERIZER_AVX2)
+        case Collision::InstructionSet::AVX2:
+            fillRows(fillRowAVX2);
+            break;
+#endif
+#if defined(BREAKOUT_RASTERIZER_SSE2)
+        case Collision::InstructionSet::SSE2:
+            fillRows(fillRowSSE2);
+            break;
+#endif
+        default:
+            fillRows(fillRowScalar);
+            break;
+    }
+}
+
+void Rasterizer::drawRect(const Rect &rect, Color color) {
+    fillRect(Rect{rect.x, rect.y, rect.w, std::min(rect.h, 1)}, color);
+    if (rect.h > 1) {
+        fillRect(Rect{rect.x, rect.y + rect.h - 1, rect.w, 1}, color);
+    }
+    if (rect.h > 2) {
+        fillRect(Rect{rect.x, rect.y + 1, 1, rect.h - 2}, color);
+        if (rect.w > 1) {
+            fillRect(Rect{rect.x + rect.w - 1, rect.y + 1, 1, rect.h - 2}, color);
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Collision.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+// CPU rasterizer for the axis-aligned rectangles the game is made of, drawing
+// into a framebuffer owned by the caller. Rows are filled with the widest
+// vector stores the CPU supports (see Collision::getInstructionSet()), and
+// rectangles are clipped to the framebuffer. Colors overwrite what is below,
+// as every sprite of the game is opaque.
+class Rasterizer {
+public:
+    enum class Format : std::uint8_t {
+        // Four bytes per pixel: red, green, blue, alpha.
+        RGBA8,
+        // One byte of BT.601 luma per pixel.
+        Gray8,
+    };
+
+    struct Color {
+        std::uint8_t r;
+        std::uint8_t g;
+        std::uint8_t b;
+        std::uint8_t a;
+    };
+
+    struct Rect {
+        int x;
+        int y;
+        int w;
+        int h;
+    };
+
+    explicit Rasterizer(Collision::InstructionSet instructionSet = Collision::getInstructionSet()) : mInstructionSet(instructionSet) {}
+
+    // pitch is the distance between rows in bytes.
+    void setTarget(std::uint8_t *pixels, int width, int height, std::ptrdiff_t pitch, Format format);
+
+    void clear(Color color);
+    void fillRect(const Rect &rect, Color color);
+    // Same pixels as SDL_RenderDrawRect: a one pixel border inside the rectangle.
+    void drawRect(const Rect &rect, Color color);
+
+    [[nodiscard]] static std::size_t getBytesPerPixel(Format format) { return format == Format::RGBA8 ? 4 : 1; }
+    [[nodiscard]] int getWidth() const { return mWidth; }
+    [[nodiscard]] int getHeight() const { return mHeight; }
+    [[nodiscard]] Format getFormat() const { return mFormat; }
+
+private:
+    std::uint8_t *mPixels = nullptr;
+    int mWidth = 0;
+    int mHeight = 0;
+    std::ptrdiff_t mPitch = 0;
+    Format mFormat = Format::RGBA8;
+    Collision::InstructionSet mInstructionSet;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Serialize.hpp"
+
+#include <entt/entt.hpp>
+
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+// Saves the listed component storages of a registry as bytes, each in packed
+// order, and loads them back into a registry under the same entity ids, so
+// views iterate a loaded registry exactly like the saved one. Components must
+// be trivially copyable.
+template<typename... Components>
+class RegistryState {
+public:
+    void save(const entt::registry &registry, std::vector<std::uint8_t> &bytes) const {
+        (savePool<Components>(registry, bytes), ...);
+    }
+
+    // Destroys every entity of the registry first. Returns false on malformed
+    // bytes, leaving the registry partially loaded.
+    bool load(entt::registry &registry, Serialize::Reader &reader) {
+        registry.clear();
+        return (loadPool<Components>(registry, reader) && ...);
+    }
+
+private:
+    template<typename Component>
+    static void savePool(const entt::registry &registry, std::vector<std::uint8_t> &bytes) {
+        static_assert(std::is_trivially_copyable_v<Component>);
+        const auto *storage = registry.storage<Component>();
+        const std::uint32_t count = storage ? static_cast<std::uint32_t>(storage->size()) : 0;
+        Serialize::write(bytes, count);
+        if (count == 0) {
+            return;
+        }
+        Serialize::writeArray(bytes, storage->data(), count);
+        if constexpr (!std::is_empty_v<Component>) {
+            for (std::uint32_t index = 0; index < count; ++index) {
+                Serialize::write(bytes, storage->get(storage->data()[index]));
+            }
+        }
+    }
+
+    template<typename Component>
+    bool loadPool(entt::registry &registry, Serialize::Reader &reader) {
+        std::uint32_t count = 0;
+        if (!reader.read(count)) {
+            return false;
+        }
+        mEntities.resize(count);
+        if (!reader.readArray(mEntities.data(), count)) {
+            return false;
+        }
+        for (const entt::entity entity: mEntities) {
+            if (!registry.valid(entity)) {
+                registry.create(entity);
+            }
+        }
+        if constexpr (std::is_empty_v<Component>) {
+            registry.insert<Component>(mEntities.begin(), mEntities.end());
+        } else {
+            std::vector<Component> &components = std::get<std::vector<Component>>(mComponents);
+            components.resize(count);
+            if (!reader.readArray(components.data(), count)) {
+                return false;
+            }
+            registry.insert<Component>(mEntities.begin(), mEntities.end(), components.begin());
+        }
+        return true;
+    }
+
+    // Scratch buffers reused by every load.
+    std::vector<entt::entity> mEntities;
+    std::tuple<std::vector<Components>...> mComponents;
+};
@@ -0,0 +1,167 @@
+#include "RenderBatch.hpp"
+
+#include <array>
+#include <cctype>
+#include <cstring>
+
+namespace {
+    // 3x5 pixel font, one row per entry with the leftmost pixel in bit 2.
+    struct Glyph {
+        char character;
+        std::array<std::uint8_t, 5> rows;
+    };
+
+    constexpr Glyph glyphs[] = {
+            {'%', {0b101, 0b001, 0b010, 0b100, 0b101}},
+            {'(', {0b001, 0b010, 0b010, 0b010, 0b001}},
+            {')', {0b100, 0b010, 0b010, 0b010, 0b100}},
+            {'-', {0b000, 0b000, 0b111, 0b000, 0b000}},
+            {'.', {0b000, 0b000, 0b000, 0b000, 0b010}},
+            {'/', {0b001, 0b001, 0b010, 0b100, 0b100}},
+            {'0', {0b111, 0b101, 0b101, 0b101, 0b111}},
+            {'1', {0b010, 0b110, 0b010, 0b010, 0b111}},
+            {'2', {0b110, 0b001, 0b010, 0b100, 0b111}},
+            {'3', {0b110, 0b001, 0b010, 0b001, 0b110}},
+            {'4', {0b101, 0b101, 0b111, 0b001, 0b001}},
+            {'5', {0b111, 0b100, 0b110, 0b001, 0b110}},
+            {'6', {0b011, 0b100, 0b111, 0b101, 0b111}},
+            {'7', {0b111, 0b001, 0b010, 0b010, 0b010}},
+            {'8', {0b111, 0b101, 0b111, 0b101, 0b111}},
+            {'9', {0b111, 0b101, 0b111, 0b001, 0b110}},
+            {':', {0b000, 0b010, 0b000, 0b010, 0b000}},
+            {'A', {0b010, 0b101, 0b111, 0b101, 0b101}},
+            {'B', {0b110, 0b101, 0b110, 0b101, 0b110}},
+            {'C', {0b011, 0b100, 0b100, 0b100, 0b011}},
+            {'D', {0b110, 0b101, 0b101, 0b101, 0b110}},
+            {'E', {0b111, 0b100, 0b110, 0b100, 0b111}},
+            {'F', {0b111, 0b100, 0b110, 0b100, 0b100}},
+            {'G', {0b011, 0b100, 0b101, 0b101, 0b011}},
+            {'H', {0b101, 0b101, 0b111, 0b101, 0b101}},
+            {'I', {0b111, 0b010, 0b010, 0b010, 0b111}},
+            {'J', {0b001, 0b001, 0b001, 0b101, 0b010}},
+            {'K', {0b101, 0b101, 0b110, 0b101, 0b101}},
+            {'L', {0b100, 0b100, 0b100, 0b100, 0b111}},
+            {'M', {0b101, 0b111, 0b111, 0b101, 0b101}},
+            {'N', {0b110, 0b101, 0b101, 0b101, 0b101}},
+            {'O', {0b010, 0b101, 0b101, 0b101, 0b010}},
+            {'P', {0b110, 0b101, 0b110, 0b100, 0b100}},
+            {'Q', {0b010, 0b101, 0b101, 0b110, 0b011}},
+            {'R', {0b110, 0b101, 0b110, 0b101, 0b101}},
+            {'S', {0b011, 0b100, 0b010, 0b001, 0b110}},
+            {'T', {0b111, 0b010, 0b010, 0b010, 0b010}},
+            {'U', {0b101, 0b101, 0b101, 0b101, 0b111}},
+            {'V', {0b101, 0b101, 0b101, 0b101, 0b010}},
+            {'W', {0b101, 0b101, 0b111, 0b111, 0b101}},
+            {'X', {0b101, 0b101, 0b010, 0b101, 0b101}},
+            {'Y', {0b101, 0b101, 0b010, 0b010, 0b010}},
+            {'Z', {0b111, 0b001, 0b010, 0b100, 0b111}},
+            {'_', {0b000, 0b000, 0b000, 0b000, 0b111}},
+    };
+
+    const Glyph *findGlyph(char character) {
+        character = static_cast<char>(std::toupper(static_cast<unsigned char>(character)));
+        for (const Glyph &glyph: glyphs) {
+            if (glyph.character == character) {
+                return &glyph;
+            }
+        }
+        return nullptr;
+    }
+}// namespace
+
+void RenderBatch::clear() {
+    mVertices.clear();
+    mIndices.clear();
+}
+
+void RenderBatch::fillRect(const SDL_Rect &rect, SDL_Color color) {
+    addQuad(static_cast<float>(rect.x), static_cast<float>(rect.y), static_cast<float>(rect.w), static_cast<float>(rect.h), color);
+}
+
+void RenderBatch::drawRect(const SDL_Rect &rect, SDL_Color color) {
+    // Same pixels as SDL_RenderDrawRect: a one pixel border inside the rectangle.
+    const auto x = static_cast<float>(rect.x);
+    const auto y = static_cast<float>(rect.y);
+    const auto w = static_cast<float>(rect.w);
+    const auto h = static_cast<float>(rect.h);
+    addQuad(x, y, w, 1.0f, color);
+    if (rect.h > 1) {
+        addQuad(x, y + h - 1.0f, w, 1.0f, color);
+    }
+    if (rect.h > 2) {
+        addQuad(x, y + 1.0f, 1.0f, h - 2.0f, color);
+        if (rect.w > 1) {
+            addQuad(x + w - 1.0f, y + 1.0f, 1.0f, h - 2.0f, color);
+        }
+    }
+}
+
+void RenderBatch::fillSquares(const float *x, const float *y, const std::uint32_t *colors, std::size_t count, float size) {
+    // Grows the buffers once and writes the quads in place rather than
+    // pushing a hundred thousand of them one vertex at a time.
+    const std::size_t firstVertex = mVertices.size();
+    const std::size_t firstIndex = mIndices.size();
+    mVertices.resize(firstVertex + count * 4);
+    mIndices.resize(firstIndex + count * 6);
+    const float half = size * 0.5f;
+    SDL_Vertex *vertex = mVertices.data() + firstVertex;
+    int *index = mIndices.data() + firstIndex;
+    for (std::size_t square = 0; square < count; ++square, vertex += 4, index += 6) {
+        SDL_Color color;
+        std::memcpy(&color, colors + square, sizeof(color));
+        const float left = x[square] - half;
+        const float top = y[square] - half;
+        vertex[0] = SDL_Vertex{SDL_FPoint{left, top}, color, SDL_FPoint{0.0f, 0.0f}};
+        vertex[1] = SDL_Vertex{SDL_FPoint{left + size, top}, color, SDL_FPoint{0.0f, 0.0f}};
+        vertex[2] = SDL_Vertex{SDL_FPoint{left + size, top + size}, color, SDL_FPoint{0.0f, 0.0f}};
+        vertex[3] = SDL_Vertex{SDL_FPoint{left, top + size}, color, SDL_FPoint{0.0f, 0.0f}};
+        const int first = static_cast<int>(firstVertex + square * 4);
+        index[0] = first;
+        index[1] = first + 1;
+        index[2] = first + 2;
+        index[3] = first;
+        index[4] = first + 2;
+        index[5] = first + 3;
+    }
+}
+
+void RenderBatch::drawText(int x, int y, std::string_view text, SDL_Color color, int scale) {
+    const int advance = 4 * scale;
+    int cursor = x;
+    for (const char character: text) {
+        if (character == '\n') {
+            cursor = x;
+            y += 6 * scale;
+            continue;
+        }
+        if (const Glyph *glyph = findGlyph(character)) {
+            for (int row = 0; row < 5; ++row) {
+                for (int column = 0; column < 3; ++column) {
+                    if (glyph->rows[static_cast<std::size_t>(row)] & (0b100 >> column)) {
+                        addQuad(static_cast<float>(cursor + column * scale), static_cast<float>(y + row * scale), static_cast<float>(scale), static_cast<float>(scale), color);
+                    }
+                }
+            }
+        }
+        cursor += advance;
+    }
+}
+
+void RenderBatch::submit(SDL_Renderer *renderer) {
+    if (mIndices.empty()) {
+        return;
+    }
+    if (SDL_RenderGeometry(renderer, nullptr, mVertices.data(), static_cast<int>(mVertices.size()), mIndices.data(), static_cast<int>(mIndices.size())) < 0) {
+        SDL_Log("Failed to render geometry: %s", SDL_GetError());
+    }
+    ++mSubmissions;
+}
+
+void RenderBatch::addQuad(float x, float y, float w, float h, SDL_Color color) {
+    const int first = static_cast<int>(mVertices.size());
+    mVertices.push_back(SDL_Vertex{SDL_FPoint{x, y}, color, SDL_FPoint{0.0f, 0.0f}});
+    mVertices.push_back(SDL_Vertex{SDL_FPoint{x + w, y}, color, SDL_FPoint{0.0f, 0.0f}});
+    mVertices.push_back(SDL_Vertex{SDL_FPoint{x + w, y + h}, color, SDL_FPoint{0.0f, 0.0f}});
+    mVertices.push_back(SDL_Vertex{SDL_FPoint{x, y + h}, color, SDL_FPoint{0.0f, 0.0f}});
+    mIndices.insert(mIndices.end(), {first, first + 1, first + 2, first, first + 2, first + 3});
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#define SDL_MAIN_HANDLED
+#include <SDL2/SDL.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Collects filled and outlined rectangles as colored quads and submits the
+// whole frame with a single SDL_RenderGeometry call. Quads are drawn in the
+// order they were added, so later rectangles cover earlier ones.
+class RenderBatch {
+public:
+    void clear();
+
+    void fillRect(const SDL_Rect &rect, SDL_Color color);
+    void drawRect(const SDL_Rect &rect, SDL_Color color);
+    // Squares of side size centered on each point, e.g. particles. Colors are
+    // RGBA bytes in memory order, the layout of SDL_Color.
+    void fillSquares(const float *x, const float *y, const std::uint32_t *colors, std::size_t count, float size);
+    // Uppercase letters, digits and a few symbols in a 3x5 pixel font scaled by scale.
+    void drawText(int x, int y, std::string_view text, SDL_Color color, int scale = 1);
+
+    void submit(SDL_Renderer *renderer);
+
+    [[nodiscard]] std::size_t getQuadCount() const { return mVertices.size() / 4; }
+    // Draw calls issued since the last resetSubmissions().
+    [[nodiscard]] std::uint32_t getSubmissions() const { return mSubmissions; }
+    void resetSubmissions() { mSubmissions = 0; }
+
+private:
+    void addQuad(float x, float y, float w, float h, SDL_Color color);
+
+    std::vector<SDL_Vertex> mVertices;
+    std::vector<int> mIndices;
+    std::uint32_t mSubmissions = 0;
+};
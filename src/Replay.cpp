@@ -0,0 +1,181 @@
+#include "Replay.hpp"
+
+#include <cstring>
+#include <fstream>
+
+namespace Replay {
+    std::uint8_t encode(const Simulation::Input &input) {
+        return static_cast<std::uint8_t>((input.left ? 1u : 0u) | (input.right ? 2u : 0u));
+    }
+
+    Simulation::Input decode(std::uint8_t bits) {
+        Simulation::Input input;
+        input.left = (bits & 1u) != 0;
+        input.right = (bits & 2u) != 0;
+        return input;
+    }
+
+    Recorder::Recorder(const Simulation::Config &config, float tickRate, std::uint32_t flags, std::uint32_t checkpointInterval) {
+        std::memcpy(mHeader.magic, "BRKR", sizeof(mHeader.magic));
+        mHeader.version = version;
+        mHeader.tickRate = tickRate;
+        mHeader.balls = config.balls;
+        mHeader.brickRows = config.brickRows;
+        mHeader.brickColumns = config.brickColumns;
+        mHeader.brickSize[0] = config.brickSize.x;
+        mHeader.brickSize[1] = config.brickSize.y;
+        mHeader.ballVelocity[0] = config.ballVelocity.x;
+        mHeader.ballVelocity[1] = config.ballVelocity.y;
+        mHeader.checkpointInterval = checkpointInterval > 0 ? checkpointInterval : 1;
+        mHeader.flags = flags | (config.denseBricks ? DenseBricks : 0u) | (config.multiBall ? MultiBall : 0u);
+    }
+
+    void Recorder::setLevel(const Level::File &level) {
+        mHeader.flags |= CustomLevel;
+        mHeader.levelHash = level.getHash();
+    }
+
+    void Recorder::record(const Simulation::Input &input) {
+        const std::uint8_t bits = encode(input);
+        if (mRunLength > 0 && bits != mRunInput) {
+            flushRun();
+        }
+        mRunInput = bits;
+        ++mRunLength;
+        ++mHeader.steps;
+    }
+
+    void Recorder::checkpoint(std::uint64_t hash) {
+        mCheckpoints.push_back(Checkpoint{mHeader.steps, hash});
+    }
+
+    bool Recorder::save(const std::string &path) {
+        if (mRunLength > 0) {
+            flushRun();
+        }
+        mHeader.runBytes = mRuns.size();
+        mHeader.checkpointCount = static_cast<std::uint32_t>(mCheckpoints.size());
+
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        stream.write(reinterpret_cast<const char *>(&mHeader), sizeof(mHeader));
+        stream.write(reinterpret_cast<const char *>(mRuns.data()), static_cast<std::streamsize>(mRuns.size()));
+        stream.write(reinterpret_cast<const char *>(mCheckpoints.data()), static_cast<std::streamsize>(mCheckpoints.size() * sizeof(Checkpoint)));
+        return static_cast<bool>(stream);
+    }
+
+    void Recorder::flushRun() {
+        mRuns.push_back(mRunInput);
+        std::uint64_t length = mRunLength;
+        do {
+            const auto byte = static_cast<std::uint8_t>(length & 0x7Fu);
+            length >>= 7u;
+            mRuns.push_back(length > 0 ? static_cast<std::uint8_t>(byte | 0x80u) : byte);
+        } while (length > 0);
+        mRunLength = 0;
+    }
+
+    File::~File() {
+        close();
+    }
+
+    bool File::open(const std::string &path) {
+        close();
+        if (!mFile.open(path, true) || mFile.getSize() < sizeof(Header)) {
+            close();
+            return false;
+        }
+        mData = mFile.getData();
+        mSize = mFile.getSize();
+
+        std::memcpy(&mHeader, mData, sizeof(Header));
+        const std::uint64_t checkpointBytes = static_cast<std::uint64_t>(mHeader.checkpointCount) * sizeof(Checkpoint);
+        if (std::memcmp(mHeader.magic, "BRKR", sizeof(mHeader.magic)) != 0 || mHeader.version != version || !(mHeader.tickRate > 0.0f) || mHeader.checkpointInterval == 0 ||
+            mHeader.runBytes > mSize - sizeof(Header) || checkpointBytes > mSize - sizeof(Header) - mHeader.runBytes) {
+            close();
+            return false;
+        }
+        mRuns = mData + sizeof(Header);
+        mCheckpoints = mRuns + mHeader.runBytes;
+        return true;
+    }
+
+    void File::close() {
+        mFile.close();
+        mData = nullptr;
+        mSize = 0;
+        mRuns = nullptr;
+        mCheckpoints = nullptr;
+    }
+
+    Simulation::Config File::getConfig() const {
+        Simulation::Config config;
+        config.balls = mHeader.balls;
+        config.brickRows = mHeader.brickRows;
+        config.brickColumns = mHeader.brickColumns;
+        config.brickSize = glm::vec2(mHeader.brickSize[0], mHeader.brickSize[1]);
+        config.ballVelocity = glm::vec2(mHeader.ballVelocity[0], mHeader.ballVelocity[1]);
+        config.denseBricks = (mHeader.flags & DenseBricks) != 0;
+        config.multiBall = (mHeader.flags & MultiBall) != 0;
+        return config;
+    }
+
+    File::Result File::play(const Level::File *level) const {
+        Result result;
+        if (!mData) {
+            return result;
+        }
+        if ((mHeader.flags & CustomLevel) == 0) {
+            level = nullptr;
+        } else if (!level || level->getHash() != mHeader.levelHash) {
+            result.wrongLevel = true;
+            return result;
+        }
+
+        Simulation simulation(getConfig(), level);
+        simulation.reset();
+
+        const float fixedDeltaTime = 1.0f / mHeader.tickRate;
+        const bool updateEveryStep = (mHeader.flags & UpdateEveryStep) != 0;
+
+        std::uint32_t checkpointIndex = 0;
+        Checkpoint checkpoint{0, 0};
+        if (mHeader.checkpointCount > 0) {
+            std::memcpy(&checkpoint, mCheckpoints, sizeof(Checkpoint));
+        }
+
+        const std::uint8_t *cursor = mRuns;
+        const std::uint8_t *end = mRuns + mHeader.runBytes;
+        while (cursor < end) {
+            const Simulation::Input input = decode(*cursor++);
+            std::uint64_t length = 0;
+            for (std::uint32_t shift = 0; cursor < end && shift < 64; shift += 7) {
+                const std::uint8_t byte = *cursor++;
+                length |= static_cast<std::uint64_t>(byte & 0x7Fu) << shift;
+                if ((byte & 0x80u) == 0) {
+                    break;
+                }
+            }
+
+            for (std::uint64_t step = 0; step < length; ++step) {
+                simulation.fixedUpdate(fixedDeltaTime, input);
+                ++result.steps;
+
+                if (checkpointIndex < mHeader.checkpointCount && checkpoint.step == result.steps) {
+                    ++result.checkpoints;
+                    if (simulation.getStateHash() != checkpoint.hash) {
+                        result.mismatchStep = result.steps;
+                        return result;
+                    }
+                    if (++checkpointIndex < mHeader.checkpointCount) {
+                        std::memcpy(&checkpoint, mCheckpoints + checkpointIndex * sizeof(Checkpoint), sizeof(Checkpoint));
+                    }
+                }
+
+                if (updateEveryStep) {
+                    simulation.update();
+                }
+            }
+        }
+        return result;
+    }
+}// namespace Replay
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Level.hpp"
+#include "MappedFile.hpp"
+#include "Simulation.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Binary replay format, little-endian:
+//   Header
+//   runBytes bytes of input runs: one input byte (bit 0 left, bit 1 right)
+//     followed by the run length as an LEB128 varint
+//   checkpointCount Checkpoint entries
+namespace Replay {
+    inline constexpr std::uint32_t version = 2;
+
+    enum Flags : std::uint32_t {
+        // Simulation::update() runs after every step, as in the interactive game.
+        UpdateEveryStep = 1u << 0u,
+        // Bricks were kept in a BrickField (Simulation::Config::denseBricks).
+        DenseBricks = 1u << 1u,
+        // Played on a level file whose Level::File::getHash() is levelHash.
+        CustomLevel = 1u << 2u,
+        // Balls collided with each other (Simulation::Config::multiBall).
+        MultiBall = 1u << 3u,
+    };
+
+    struct Header {
+        char magic[4];
+        std::uint32_t version;
+        float tickRate;
+        std::uint32_t balls;
+        std::uint32_t brickRows;
+        std::uint32_t brickColumns;
+        float brickSize[2];
+        float ballVelocity[2];
+        std::uint32_t checkpointInterval;
+        std::uint32_t checkpointCount;
+        std::uint32_t flags;
+        std::uint32_t levelHash;
+        std::uint64_t steps;
+        std::uint64_t runBytes;
+    };
+    static_assert(sizeof(Header) == 72);
+
+    struct Checkpoint {
+        std::uint64_t step;
+        std::uint64_t hash;
+    };
+    static_assert(sizeof(Checkpoint) == 16);
+
+    class Recorder {
+    public:
+        Recorder(const Simulation::Config &config, float tickRate, std::uint32_t flags, std::uint32_t checkpointInterval = 240);
+
+        // Marks the recording as played on level instead of the built-in one.
+        void setLevel(const Level::File &level);
+
+        // Call once per fixed step with the input about to be applied.
+        void record(const Simulation::Input &input);
+
+        // True when the step just recorded should be followed by checkpoint().
+        [[nodiscard]] bool isCheckpointDue() const { return mHeader.steps % mHeader.checkpointInterval == 0; }
+        void checkpoint(std::uint64_t hash);
+
+        bool save(const std::string &path);
+
+    private:
+        void flushRun();
+
+        Header mHeader{};
+        std::vector<std::uint8_t> mRuns;
+        std::vector<Checkpoint> mCheckpoints;
+        std::uint8_t mRunInput = 0;
+        std::uint64_t mRunLength = 0;
+    };
+
+    // Read-only view of a memory-mapped replay file.
+    class File {
+    public:
+        File() = default;
+        ~File();
+
+        File(const File &) = delete;
+        File &operator=(const File &) = delete;
+
+        bool open(const std::string &path);
+        void close();
+
+        [[nodiscard]] const Header &getHeader() const { return mHeader; }
+        [[nodiscard]] Simulation::Config getConfig() const;
+
+        struct Result {
+            std::uint64_t steps = 0;
+            std::uint64_t checkpoints = 0;
+            // Step of the first checkpoint whose hash differs, 0 when all match.
+            std::uint64_t mismatchStep = 0;
+            // The replay needs a level file and level is missing or a different one; nothing was played.
+            bool wrongLevel = false;
+        };
+
+        // Replays every input through a fresh simulation and compares the checkpoints.
+        [[nodiscard]] Result play(const Level::File *level = nullptr) const;
+
+    private:
+        Header mHeader{};
+        MappedFile mFile;
+        const std::uint8_t *mData = nullptr;
+        std::size_t mSize = 0;
+        const std::uint8_t *mRuns = nullptr;
+        const std::uint8_t *mCheckpoints = nullptr;
+    };
+
+    std::uint8_t encode(const Simulation::Input &input);
+    Simulation::Input decode(std::uint8_t bits);
+}// namespace Replay
@@ -0,0 +1,94 @@
+#include "Replay.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+namespace {
+    void printUsage(const char *program) {
+        std::fprintf(stderr,
+                     "Usage: %s [--repeat N] [--level FILE] <replay or directory>...\n"
+                     "Replays every file (directories are searched for *.replay) headless at\n"
+                     "full speed, verifies the recorded state hashes and reports throughput.\n"
+                     "Replays recorded on a level file need it passed with --level.\n",
+                     program);
+    }
+}// namespace
+
+int main(int argc, char **argv) {
+    std::size_t repeat = 1;
+    Level::File level;
+    std::vector<std::filesystem::path> paths;
+    for (int index = 1; index < argc; ++index) {
+        const std::string_view argument = argv[index];
+        if (argument == "--repeat" && index + 1 < argc) {
+            repeat = std::max<std::size_t>(std::strtoull(argv[++index], nullptr, 10), 1);
+        } else if (argument == "--level" && index + 1 < argc) {
+            if (!level.open(argv[++index])) {
+                std::fprintf(stderr, "Failed to open level %s\n", argv[index]);
+                return EXIT_FAILURE;
+            }
+        } else if (argument.starts_with("--")) {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        } else if (std::filesystem::is_directory(argument)) {
+            for (const auto &entry: std::filesystem::recursive_directory_iterator(argument)) {
+                if (entry.is_regular_file() && entry.path().extension() == ".replay") {
+                    paths.push_back(entry.path());
+                }
+            }
+        } else {
+            paths.emplace_back(argument);
+        }
+    }
+    if (paths.empty()) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    std::sort(paths.begin(), paths.end());
+
+    bool failed = false;
+    std::uint64_t totalSteps = 0;
+    double totalSeconds = 0.0;
+
+    std::printf("file,steps,checkpoints,seconds,steps_per_sec,status\n");
+    for (const std::filesystem::path &path: paths) {
+        Replay::File file;
+        if (!file.open(path.string())) {
+            std::printf("%s,0,0,0,0,unreadable\n", path.string().c_str());
+            failed = true;
+            continue;
+        }
+
+        Replay::File::Result result;
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t iteration = 0; iteration < repeat; ++iteration) {
+            result = file.play(level.isOpen() ? &level : nullptr);
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        const bool complete = result.steps == file.getHeader().steps;
+        const bool matched = result.mismatchStep == 0 && complete;
+        failed = failed || !matched;
+        totalSteps += result.steps * repeat;
+        totalSeconds += elapsed.count();
+
+        std::printf("%s,%llu,%llu,%.6f,%.0f,", path.string().c_str(), static_cast<unsigned long long>(result.steps), static_cast<unsigned long long>(result.checkpoints), elapsed.count(), static_cast<double>(result.steps * repeat) / elapsed.count());
+        if (result.wrongLevel) {
+            std::printf("wrong level\n");
+        } else if (matched) {
+            std::printf("ok\n");
+        } else if (!complete && result.mismatchStep == 0) {
+            std::printf("truncated\n");
+        } else {
+            std::printf("mismatch at step %llu\n", static_cast<unsigned long long>(result.mismatchStep));
+        }
+    }
+
+    std::fprintf(stderr, "replays: %zu, steps: %llu in %.3f s (%.0f steps/s)\n", paths.size(), static_cast<unsigned long long>(totalSteps), totalSeconds, static_cast<double>(totalSteps) / totalSeconds);
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,77 @@
+#include "Rollback.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+Rollback::Rollback(Simulation &simulation, float fixedDeltaTime) : mSimulation(simulation), mFixedDeltaTime(fixedDeltaTime) {}
+
+Simulation::Input Rollback::combine(const Simulation::Input &first, const Simulation::Input &second) {
+    Simulation::Input input;
+    input.left = first.left || second.left;
+    input.right = first.right || second.right;
+    return input;
+}
+
+void Rollback::advance(const Simulation::Input &local) {
+    synchronize();
+
+    Frame &frame = getFrame(mTick);
+    frame.local = local;
+    if (mTick >= mConfirmedTick) {
+        frame.remote = mLastRemote;
+    }
+    step(frame);
+    ++mTick;
+    mRollbackTick = mTick;
+}
+
+bool Rollback::receive(std::uint64_t tick, const Simulation::Input &remote) {
+    // Input too far ahead would share its frame with a tick that has yet to
+    // run or to be run again by a pending rollback; it is sent again later.
+    if (tick != mConfirmedTick || tick >= std::min(mRollbackTick, mTick) + maxPrediction) {
+        return false;
+    }
+    if (tick < mTick) {
+        const Simulation::Input &predicted = getFrame(tick).remote;
+        if (predicted.left != remote.left || predicted.right != remote.right) {
+            mRollbackTick = std::min(mRollbackTick, tick);
+        }
+    }
+    getFrame(tick).remote = remote;
+    mLastRemote = remote;
+    ++mConfirmedTick;
+    return true;
+}
+
+void Rollback::synchronize() {
+    if (mRollbackTick >= mTick) {
+        return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const Frame &first = getFrame(mRollbackTick);
+    mSimulation.loadState(first.state.data(), first.state.size());
+    for (std::uint64_t tick = mRollbackTick; tick < mTick; ++tick) {
+        // Ticks past the confirmed ones are predicted again from the newest remote input.
+        Frame &frame = getFrame(tick);
+        if (tick >= mConfirmedTick) {
+            frame.remote = mLastRemote;
+        }
+        step(frame);
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    const auto depth = static_cast<std::uint32_t>(mTick - mRollbackTick);
+    ++mStats.rollbacks;
+    mStats.resimulatedTicks += depth;
+    mStats.maxDepth = std::max(mStats.maxDepth, depth);
+    mStats.totalSeconds += elapsed.count();
+    mStats.maxSeconds = std::max(mStats.maxSeconds, elapsed.count());
+    mRollbackTick = mTick;
+}
+
+void Rollback::step(Frame &frame) {
+    mSimulation.saveState(frame.state);
+    mSimulation.fixedUpdate(mFixedDeltaTime, combine(frame.local, frame.remote));
+    mSimulation.update();
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Simulation.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Rollback netcode for two players sharing one simulation. Every tick runs with
+// the local input and the remote input received for it, or with a prediction
+// (the last remote input received) while that is still on its way. When a
+// remote input arrives that differs from its prediction, the simulation goes
+// back to the state saved before that tick and runs the ticks since again.
+class Rollback {
+public:
+    // Ticks the simulation may run ahead of the last confirmed remote input;
+    // one saved state is kept for each.
+    static constexpr std::uint32_t maxPrediction = 16;
+
+    struct Stats {
+        std::uint64_t rollbacks = 0;
+        std::uint64_t resimulatedTicks = 0;
+        std::uint32_t maxDepth = 0;
+        // Time spent restoring and re-simulating, in seconds.
+        double totalSeconds = 0.0;
+        double maxSeconds = 0.0;
+    };
+
+    // The simulation must be reset and must not be stepped by anyone else.
+    Rollback(Simulation &simulation, float fixedDeltaTime);
+
+    // Both players steer the paddle; either direction pressed by either player counts.
+    static Simulation::Input combine(const Simulation::Input &first, const Simulation::Input &second);
+
+    // False while the simulation is maxPrediction ticks ahead of the remote
+    // input: the caller has to wait for remote input before advancing again.
+    [[nodiscard]] bool canAdvance() const { return mTick < mConfirmedTick + maxPrediction; }
+
+    // Runs the next tick with the local input, rolling back first if needed.
+    void advance(const Simulation::Input &local);
+
+    // Remote input of one tick. Inputs must arrive in tick order: anything but
+    // the tick after the last confirmed one, or maxPrediction or more ticks
+    // ahead of the simulation or of a pending rollback, is ignored and false
+    // returned.
+    bool receive(std::uint64_t tick, const Simulation::Input &remote);
+
+    // Performs a pending rollback now instead of on the next advance().
+    void synchronize();
+
+    // The tick advance() runs next.
+    [[nodiscard]] std::uint64_t getTick() const { return mTick; }
+    // Ticks before this one ran with the real remote input.
+    [[nodiscard]] std::uint64_t getConfirmedTick() const { return mConfirmedTick; }
+    [[nodiscard]] const Stats &getStats() const { return mStats; }
+
+private:
+    struct Frame {
+        // Simulation state before the tick ran.
+        std::vector<std::uint8_t> state;
+        Simulation::Input local;
+        Simulation::Input remote;
+    };
+
+    [[nodiscard]] Frame &getFrame(std::uint64_t tick) { return mFrames[tick % maxPrediction]; }
+    void step(Frame &frame);
+
+    Simulation &mSimulation;
+    float mFixedDeltaTime;
+    std::array<Frame, maxPrediction> mFrames;
+    std::uint64_t mTick = 0;
+    std::uint64_t mConfirmedTick = 0;
+    // Earliest tick that ran with a wrong prediction, mTick when none did.
+    std::uint64_t mRollbackTick = 0;
+    Simulation::Input mLastRemote;
+    Stats mStats;
+};
@@ -0,0 +1,55 @@
+#include "Scene.hpp"
+
+#include <glm/glm.hpp>
+
+namespace {
+    // Rounds both corners down so neighbouring boxes stay gapless at any scale.
+    Rasterizer::Rect toRect(const Component::Transform &transform, glm::vec2 scale) {
+        const glm::vec2 min = glm::floor(transform.position * scale);
+        const glm::vec2 max = glm::floor((transform.position + transform.scale) * scale);
+        return Rasterizer::Rect{static_cast<int>(min.x), static_cast<int>(min.y), static_cast<int>(max.x - min.x), static_cast<int>(max.y - min.y)};
+    }
+
+    Rasterizer::Color toColor(const Component::Color &color) {
+        return Rasterizer::Color{color.r, color.g, color.b, color.a};
+    }
+
+    void drawSprite(Rasterizer &rasterizer, const Rasterizer::Rect &rect, const Component::Color &fill) {
+        rasterizer.fillRect(rect, toColor(fill));
+        rasterizer.drawRect(rect, toColor(Scene::getOutlineColor(fill)));
+    }
+}// namespace
+
+namespace Scene {
+    Component::Color getOutlineColor(const Component::Color &fill) {
+        return Component::Color{static_cast<std::uint8_t>(fill.r * 0.8f), static_cast<std::uint8_t>(fill.g * 0.8f), static_cast<std::uint8_t>(fill.b * 0.8f), fill.a};
+    }
+
+    void rasterize(const Simulation &simulation, Rasterizer &rasterizer) {
+        const glm::vec2 scale(static_cast<float>(rasterizer.getWidth()) / width, static_cast<float>(rasterizer.getHeight()) / height);
+        const Rasterizer::Color black{0, 0, 0, 255};
+        const entt::registry &registry = simulation.getRegistry();
+        const BrickField &brickField = simulation.getBrickField();
+
+        // Same order as Application::render(): bricks, then goal and walls, then balls and paddles.
+        rasterizer.clear(black);
+        registry.view<const Component::Brick, const Component::Transform, const Component::Sprite>().each([&](entt::entity, const Component::Transform &transform, const Component::Sprite &sprite) {
+            drawSprite(rasterizer, toRect(transform, scale), sprite.color);
+        });
+        brickField.forEachAlive([&](std::uint32_t cell) {
+            drawSprite(rasterizer, toRect(brickField.getTransform(cell), scale), brickField.getColor(cell));
+        });
+        registry.view<const Component::Goal, const Component::Transform>().each([&](entt::entity, const Component::Transform &transform) {
+            rasterizer.fillRect(toRect(transform, scale), black);
+        });
+        registry.view<const Component::Wall, const Component::Transform>().each([&](entt::entity, const Component::Transform &transform) {
+            rasterizer.fillRect(toRect(transform, scale), black);
+        });
+        registry.view<const Component::Ball, const Component::Transform, const Component::Sprite>().each([&](entt::entity, const Component::Transform &transform, const Component::Sprite &sprite) {
+            drawSprite(rasterizer, toRect(transform, scale), sprite.color);
+        });
+        registry.view<const Component::Paddle, const Component::Transform, const Component::Sprite>().each([&](entt::entity, const Component::Transform &transform, const Component::Sprite &sprite) {
+            drawSprite(rasterizer, toRect(transform, scale), sprite.color);
+        });
+    }
+}// namespace Scene
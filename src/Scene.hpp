@@ -0,0 +1,18 @@
+#pragma once
+
+#include "Component.hpp"
+#include "Rasterizer.hpp"
+#include "Simulation.hpp"
+
+namespace Scene {
+    // Size of the playfield in world units, shown 1:1 in the game's window.
+    inline constexpr int width = 800;
+    inline constexpr int height = 600;
+
+    // Color of the outline drawn around bricks, balls and paddles of the given fill.
+    [[nodiscard]] Component::Color getOutlineColor(const Component::Color &fill);
+
+    // Draws the simulation like the game window does, stretching the
+    // playfield over the rasterizer's whole framebuffer.
+    void rasterize(const Simulation &simulation, Rasterizer &rasterizer);
+}// namespace Scene
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// Raw byte packing of trivially copyable values in host byte order, for state
+// snapshots and network packets exchanged between identical builds.
+namespace Serialize {
+    template<typename T>
+    void write(std::vector<std::uint8_t> &bytes, const T &value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const auto *data = reinterpret_cast<const std::uint8_t *>(&value);
+        bytes.insert(bytes.end(), data, data + sizeof(T));
+    }
+
+    template<typename T>
+    void writeArray(std::vector<std::uint8_t> &bytes, const T *values, std::size_t count) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const auto *data = reinterpret_cast<const std::uint8_t *>(values);
+        bytes.insert(bytes.end(), data, data + count * sizeof(T));
+    }
+
+    // Reads values back in the order they were written. A read that would run
+    // past the end fails and leaves the value untouched.
+    class Reader {
+    public:
+        Reader(const std::uint8_t *data, std::size_t size) : mData(data), mEnd(data + size) {}
+
+        template<typename T>
+        bool read(T &value) {
+            return readArray(&value, 1);
+        }
+
+        template<typename T>
+        bool readArray(T *values, std::size_t count) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            if (count > static_cast<std::size_t>(mEnd - mData) / sizeof(T)) {
+                return false;
+            }
+            std::memcpy(values, mData, count * sizeof(T));
+            mData += count * sizeof(T);
+            return true;
+        }
+
+        [[nodiscard]] bool atEnd() const { return mData == mEnd; }
+
+    private:
+        const std::uint8_t *mData;
+        const std::uint8_t *mEnd;
+    };
+}// namespace Serialize
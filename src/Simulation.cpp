@@ -0,0 +1,548 @@
+#include "Simulation.hpp"
+
+#include "Collision.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace {
+    // Upper bound on the bounces resolved for one ball within a single fixed step.
+    constexpr std::uint32_t maxContactsPerStep = 4;
+
+    enum class Target { None, Goal, Wall, Brick, BrickCell, Paddle };
+
+    struct Hit {
+        Target target = Target::None;
+        entt::entity entity = entt::null;
+        std::uint32_t cell = 0;
+        Collision::Contact contact{std::numeric_limits<float>::max(), glm::vec2(0.0f, 0.0f)};
+    };
+
+    template<typename Component>
+    Simulation::StorageUsage getUsage(const entt::registry &registry) {
+        Simulation::StorageUsage usage;
+        usage.name = entt::type_id<Component>().name();
+        if (const auto *storage = registry.storage<Component>()) {
+            // Tags such as Component::Ball only keep the entities.
+            constexpr std::size_t componentSize = std::is_empty_v<Component> ? 0 : sizeof(Component);
+            usage.size = storage->size();
+            usage.capacity = storage->capacity();
+            usage.bytes = usage.capacity * (sizeof(entt::entity) + componentSize) + storage->extent() * sizeof(entt::entity);
+        }
+        return usage;
+    }
+
+    // Left edge first, entity second: a total order, so the sorted list and
+    // the order pairs are resolved in do not depend on the previous step.
+    bool sweepsBefore(float minX, entt::entity entity, float otherMinX, entt::entity otherEntity) {
+        return minX < otherMinX || (minX == otherMinX && entity < otherEntity);
+    }
+
+    // Two overlapping balls of equal mass: they exchange their velocities along
+    // the axis they overlap least on, unless they already move apart on it.
+    void bounceBalls(glm::vec2 firstMin, glm::vec2 firstMax, glm::vec2 &firstVelocity, glm::vec2 secondMin, glm::vec2 secondMax, glm::vec2 &secondVelocity) {
+        const glm::vec2 overlap = glm::min(firstMax, secondMax) - glm::max(firstMin, secondMin);
+        // Twice the distance between the centers, which has the same sign.
+        const glm::vec2 separation = (secondMin + secondMax) - (firstMin + firstMax);
+        const glm::vec2 approach = secondVelocity - firstVelocity;
+        if (overlap.x < overlap.y) {
+            if (separation.x * approach.x < 0.0f) {
+                std::swap(firstVelocity.x, secondVelocity.x);
+            }
+        } else if (separation.y * approach.y < 0.0f) {
+            std::swap(firstVelocity.y, secondVelocity.y);
+        }
+    }
+}// namespace
+
+Simulation::Simulation(const Config &config, const Level::File *level) : mConfig(config), mLevel(level) {
+    if (!mLevel) {
+        mDefaultLevel.load(Level::serialize(Level::makeDefault(config.brickRows, config.brickColumns, config.brickSize)));
+        mLevel = &mDefaultLevel;
+    }
+
+    mRegistry.on_construct<Component::Brick>().connect<&Simulation::onBrickConstruct>(*this);
+    mRegistry.on_destroy<Component::Brick>().connect<&Simulation::onBrickDestroy>(*this);
+    mRegistry.on_construct<Component::Ball>().connect<&Simulation::onBallConstruct>(*this);
+    mRegistry.on_destroy<Component::Ball>().connect<&Simulation::onBallDestroy>(*this);
+
+    mDispatcher.sink<Event::BallLost>().connect<&Simulation::onBallLost>(*this);
+    mDispatcher.sink<Event::LevelCleared>().connect<&Simulation::onLevelCleared>(*this);
+}
+
+void Simulation::reset() {
+    mGameOver = false;
+    mSteps = 0;
+    mBricksDestroyed = 0;
+    mBallsLost = 0;
+    mRumbleDuration = 0;
+    respawn();
+}
+
+void Simulation::fixedUpdate(float fixedDeltaTime, const Input &input) {
+    updatePositions(fixedDeltaTime, input);
+    checkCollisions(fixedDeltaTime);
+    if (mConfig.multiBall) {
+        resolveBallCollisions();
+    }
+    ++mSteps;
+}
+
+void Simulation::update() {
+    if (mGameOver) {
+        mGameOver = false;
+        respawn();
+    }
+}
+
+std::vector<Simulation::StorageUsage> Simulation::getStorageUsage() const {
+    return []<typename... Components>(const entt::registry &registry, std::type_identity<std::tuple<Components...>>) {
+        return std::vector<StorageUsage>{getUsage<Components>(registry)...};
+    }(mRegistry, std::type_identity<ForComponents<std::tuple>>{});
+}
+
+std::uint64_t Simulation::getStateHash() const {
+    std::uint64_t hash = 0xCBF29CE484222325u;
+    const auto combine = [&hash](const auto &value) {
+        const auto *bytes = reinterpret_cast<const std::uint8_t *>(&value);
+        for (std::size_t index = 0; index < sizeof(value); ++index) {
+            hash = (hash ^ bytes[index]) * 0x100000001B3u;
+        }
+    };
+
+    combine(mGameOver);
+    combine(mSteps);
+    combine(mBricksDestroyed);
+    combine(mBallsLost);
+    combine(static_cast<std::size_t>(mBrickCount) + mBrickField.getAliveCount());
+    mRegistry.view<const Component::Ball, const Component::Transform, const Component::Movement>().each([&](entt::entity, const Component::Transform &transform, const Component::Movement &movement) {
+        combine(transform.position);
+        combine(movement.velocity);
+    });
+    mRegistry.view<const Component::Paddle, const Component::Transform>().each([&](entt::entity, const Component::Transform &transform) {
+        combine(transform.position);
+    });
+    return hash;
+}
+
+void Simulation::saveState(std::vector<std::uint8_t> &bytes) const {
+    bytes.clear();
+    Serialize::write(bytes, mGameOver);
+    Serialize::write(bytes, mSteps);
+    Serialize::write(bytes, mBricksDestroyed);
+    Serialize::write(bytes, mBallsLost);
+    Serialize::write(bytes, mRumbleDuration);
+    mRegistryState.save(mRegistry, bytes);
+    mBrickGrid.save(bytes);
+    mBrickField.save(bytes);
+}
+
+bool Simulation::loadState(const std::uint8_t *data, std::size_t size) {
+    // Brick and ball counts follow the registry signals while it is loaded.
+    Serialize::Reader reader(data, size);
+    return reader.read(mGameOver) && reader.read(mSteps) && reader.read(mBricksDestroyed) && reader.read(mBallsLost) && reader.read(mRumbleDuration) &&
+           mRegistryState.load(mRegistry, reader) && mBrickGrid.load(reader) && mBrickField.load(reader) && reader.atEnd();
+}
+
+std::uint32_t Simulation::consumeRumble() {
+    const std::uint32_t duration = mRumbleDuration;
+    mRumbleDuration = 0;
+    return duration;
+}
+
+void Simulation::hitBrick(entt::entity entity) {
+    if (Component::Health *health = mRegistry.try_get<Component::Health>(entity); health && --health->hitPoints > 0) {
+        return;
+    }
+    const auto [transform, sprite] = mRegistry.get<Component::Transform, Component::Sprite>(entity);
+    const Event::BrickDestroyed event{transform, sprite};
+    mBrickGrid.remove(entity, transform.position, transform.position + transform.scale);
+    mRegistry.destroy(entity);
+    ++mBricksDestroyed;
+    mDispatcher.trigger(event);
+    if (isCleared()) {
+        mDispatcher.trigger(Event::LevelCleared{});
+    }
+}
+
+void Simulation::hitBrickCell(std::uint32_t cell) {
+    if (!mBrickField.hit(cell)) {
+        return;
+    }
+    ++mBricksDestroyed;
+    mDispatcher.trigger(Event::BrickDestroyed{mBrickField.getTransform(cell), Component::Sprite{mBrickField.getColor(cell)}});
+    if (isCleared()) {
+        mDispatcher.trigger(Event::LevelCleared{});
+    }
+}
+
+void Simulation::onBrickConstruct(entt::registry &, entt::entity) {
+    ++mBrickCount;
+}
+
+void Simulation::onBrickDestroy(entt::registry &, entt::entity) {
+    --mBrickCount;
+}
+
+void Simulation::onBallConstruct(entt::registry &, entt::entity) {
+    ++mBallCount;
+    mBallsChanged = true;
+}
+
+void Simulation::onBallDestroy(entt::registry &, entt::entity) {
+    --mBallCount;
+    mBallsChanged = true;
+}
+
+void Simulation::onBallLost(const Event::BallLost &event) {
+    ++mBallsLost;
+    if (mConfig.multiBall && mBallCount > mLostBalls.size() + 1) {
+        mLostBalls.push_back(event.ball);
+        return;
+    }
+    mGameOver = true;
+}
+
+void Simulation::onLevelCleared(const Event::LevelCleared &) {
+    mGameOver = true;
+}
+
+void Simulation::rumble(std::uint32_t duration_ms) {
+    mRumbleDuration = glm::max(mRumbleDuration, duration_ms);
+}
+
+void Simulation::respawn() {
+    if (!mPrototype.isCaptured()) {
+        respawnGoal();
+        respawnWalls();
+        respawnBricks();
+        respawnBalls();
+        respawnPaddles();
+        mPrototype.capture(mRegistry);
+        mPrototypeGrid = mBrickGrid;
+        return;
+    }
+
+    // Entity ids come back unchanged, so the grid built for them stays valid
+    // and copying it over reuses the cell vectors already allocated.
+    mPrototype.restore(mRegistry);
+    mBrickGrid = mPrototypeGrid;
+    if (mConfig.denseBricks) {
+        mBrickField.assign(mLevel->getColors(), mLevel->getHitPoints());
+    }
+    mDispatcher.trigger(Event::BricksRespawned{});
+}
+
+void Simulation::respawnGoal() {
+    auto view = mRegistry.view<Component::Goal>();
+    mRegistry.destroy(view.begin(), view.end());
+
+    const Level::Box &goal = mLevel->getHeader().goal;
+    entt::entity entity = mRegistry.create();
+    mRegistry.emplace<Component::Goal>(entity);
+    mRegistry.emplace<Component::Transform>(entity, glm::vec2(goal.x, goal.y), glm::vec2(goal.width, goal.height));
+}
+
+void Simulation::respawnWalls() {
+    auto view = mRegistry.view<Component::Wall>();
+    mRegistry.destroy(view.begin(), view.end());
+
+    for (std::uint32_t index = 0; index < mLevel->getHeader().wallCount; ++index) {
+        const Level::Box wall = mLevel->getWall(index);
+        entt::entity entity = mRegistry.create();
+        mRegistry.emplace<Component::Wall>(entity);
+        mRegistry.emplace<Component::Transform>(entity, glm::vec2(wall.x, wall.y), glm::vec2(wall.width, wall.height));
+    }
+}
+
+void Simulation::respawnBricks() {
+    auto view = mRegistry.view<Component::Brick>();
+    mRegistry.destroy(view.begin(), view.end());
+
+    const Level::Header &header = mLevel->getHeader();
+    const glm::vec2 origin(header.origin[0], header.origin[1]);
+    const glm::vec2 size(header.cellSize[0], header.cellSize[1]);
+    // Within 32 bits, as Level::File::validate() checked it against Level::maxCells.
+    const auto cells = static_cast<std::uint32_t>(Level::getCellCount(header.columns, header.rows));
+    const std::uint8_t *colors = mLevel->getColors();
+    const std::uint8_t *hitPoints = mLevel->getHitPoints();
+
+    std::vector<Component::Color> palette(header.paletteSize);
+    for (std::uint32_t index = 0; index < header.paletteSize; ++index) {
+        palette[index] = mLevel->getColor(static_cast<std::uint8_t>(index));
+    }
+
+    if (mConfig.denseBricks) {
+        mBrickField.reset(origin, size, header.columns, header.rows);
+        mBrickField.setPalette(std::move(palette));
+        mBrickField.assign(colors, hitPoints);
+        mDispatcher.trigger(Event::BricksRespawned{});
+        return;
+    }
+    mBrickField.reset(origin, size, 0, 0);
+
+    // The grid covers everything a ball can reach, so balls away from the bricks query empty cells.
+    glm::vec2 min = glm::min(origin, glm::vec2(header.goal.x, header.goal.y));
+    glm::vec2 max = glm::max(origin + size * glm::vec2(header.columns, header.rows), glm::vec2(header.goal.x + header.goal.width, header.goal.y + header.goal.height));
+    for (std::uint32_t index = 0; index < header.wallCount; ++index) {
+        const Level::Box wall = mLevel->getWall(index);
+        min = glm::min(min, glm::vec2(wall.x, wall.y));
+        max = glm::max(max, glm::vec2(wall.x + wall.width, wall.y + wall.height));
+    }
+    mBrickGrid.reset(min, max - min, size);
+
+    // Bulk insert: create every brick entity at once, then fill each storage with one range.
+    const std::uint32_t count = mLevel->getBrickCount();
+    std::vector<entt::entity> entities(count);
+    std::vector<Component::Transform> transforms;
+    std::vector<Component::Sprite> sprites;
+    transforms.reserve(count);
+    sprites.reserve(count);
+    mRegistry.create(entities.begin(), entities.end());
+    for (std::uint32_t cell = 0; cell < cells; ++cell) {
+        if (hitPoints[cell] == 0) {
+            continue;
+        }
+        const glm::vec2 position = origin + glm::vec2(static_cast<float>(cell % header.columns) * size.x, static_cast<float>(cell / header.columns) * size.y);
+        mBrickGrid.insert(entities[transforms.size()], position, position + size);
+        transforms.push_back(Component::Transform{position, size});
+        sprites.push_back(Component::Sprite{palette[colors[cell]]});
+    }
+    mRegistry.insert<Component::Brick>(entities.begin(), entities.end());
+    mRegistry.insert<Component::Transform>(entities.begin(), entities.end(), transforms.begin());
+    mRegistry.insert<Component::Sprite>(entities.begin(), entities.end(), sprites.begin());
+    for (std::uint32_t cell = 0, brick = 0; cell < cells; ++cell) {
+        if (hitPoints[cell] > 1) {
+            mRegistry.emplace<Component::Health>(entities[brick], hitPoints[cell]);
+        }
+        brick += hitPoints[cell] != 0;
+    }
+
+    mDispatcher.trigger(Event::BricksRespawned{});
+}
+
+void Simulation::respawnBalls() {
+    auto view = mRegistry.view<Component::Ball>();
+    mRegistry.destroy(view.begin(), view.end());
+
+    // Extra balls leave the spawn box with the default launch velocity rotated by evenly spread angles.
+    const Level::Header &header = mLevel->getHeader();
+    const Level::Box &spawn = header.ball;
+    const glm::vec2 velocity = mConfig.ballVelocity;
+
+    // Multi-ball games instead start from a grid over the open space between
+    // the bricks and the paddle, so thousands of balls do not begin stacked
+    // on one spot where every pair overlaps.
+    glm::vec2 first(spawn.x, spawn.y);
+    glm::vec2 spacing(0.0f, 0.0f);
+    std::uint32_t columns = 1;
+    const glm::vec2 openMin(header.goal.x, header.origin[1] + header.cellSize[1] * static_cast<float>(header.rows));
+    const glm::vec2 openSize = glm::vec2(header.goal.x + header.goal.width - spawn.width, header.paddle.y - spawn.height) - openMin;
+    if (mConfig.multiBall && mConfig.balls > 1 && openSize.x > 0.0f && openSize.y > 0.0f) {
+        columns = glm::max(static_cast<std::uint32_t>(glm::ceil(glm::sqrt(static_cast<float>(mConfig.balls) * openSize.x / openSize.y))), 1u);
+        const std::uint32_t rows = (mConfig.balls + columns - 1) / columns;
+        spacing = openSize / glm::vec2(static_cast<float>(columns), static_cast<float>(rows));
+        first = openMin + 0.5f * spacing;
+    }
+
+    for (std::uint32_t ball = 0; ball < mConfig.balls; ++ball) {
+        const float angle = 2.0f * glm::pi<float>() * static_cast<float>(ball) / static_cast<float>(mConfig.balls);
+        const float cos = glm::cos(angle);
+        const float sin = glm::sin(angle);
+        const glm::vec2 position = first + spacing * glm::vec2(static_cast<float>(ball % columns), static_cast<float>(ball / columns));
+        entt::entity entity = mRegistry.create();
+        mRegistry.emplace<Component::Ball>(entity);
+        mRegistry.emplace<Component::Transform>(entity, position, glm::vec2(spawn.width, spawn.height));
+        mRegistry.emplace<Component::Sprite>(entity, Component::Color{255, 255, 255, 255});
+        mRegistry.emplace<Component::Movement>(entity, glm::vec2(cos * velocity.x - sin * velocity.y, sin * velocity.x + cos * velocity.y));
+    }
+}
+
+void Simulation::respawnPaddles() {
+    auto view = mRegistry.view<Component::Paddle>();
+    mRegistry.destroy(view.begin(), view.end());
+
+    const Level::Header &header = mLevel->getHeader();
+    entt::entity entity = mRegistry.create();
+    mRegistry.emplace<Component::Paddle>(entity);
+    mRegistry.emplace<Component::Transform>(entity, glm::vec2(header.paddle.x, header.paddle.y), glm::vec2(header.paddle.width, header.paddle.height));
+    mRegistry.emplace<Component::Sprite>(entity, Component::Color{255, 255, 255, 255});
+    mRegistry.emplace<Component::Movement>(entity, glm::vec2(header.paddleSpeed, 0.0f));
+}
+
+void Simulation::updatePositions(float fixedDeltaTime, const Input &input) {
+    const Profiler::Scope scope(mProfiler, "updatePositions");
+
+    auto paddleView = mRegistry.view<Component::Paddle, Component::Transform, Component::Movement>();
+    paddleView.each([&](entt::entity, Component::Transform &paddleTransform, const Component::Movement &paddleMovement) {
+        auto goalView = mRegistry.view<Component::Goal, Component::Transform>();
+        goalView.each([&](entt::entity, const Component::Transform &goalTransform) {
+            if (paddleTransform.position.x > 0.0f) {
+                if (input.left) {
+                    paddleTransform.position.x -= paddleMovement.velocity.x * fixedDeltaTime;
+                }
+            }
+            if (paddleTransform.position.x + paddleTransform.scale.x < goalTransform.scale.x) {
+                if (input.right) {
+                    paddleTransform.position.x += paddleMovement.velocity.x * fixedDeltaTime;
+                }
+            }
+        });
+    });
+}
+
+void Simulation::checkCollisions(float fixedDeltaTime) {
+    const Profiler::Scope scope(mProfiler, "checkCollisions");
+
+    auto ballView = mRegistry.view<Component::Ball, Component::Transform, Component::Movement>();
+    auto goalView = mRegistry.view<Component::Goal, Component::Transform>();
+    auto wallView = mRegistry.view<Component::Wall, Component::Transform>();
+    auto paddleView = mRegistry.view<Component::Paddle, Component::Transform>();
+
+    ballView.each([&](entt::entity ball, Component::Transform &ballTransform, Component::Movement &ballMovement) {
+        // Advance the ball to its earliest contact, bounce, and continue with the rest of the step.
+        float remaining = 1.0f;
+        for (std::uint32_t contact = 0; contact < maxContactsPerStep && remaining > 0.0f; ++contact) {
+            const glm::vec2 displacement = ballMovement.velocity * (fixedDeltaTime * remaining);
+
+            Hit hit;
+            const auto sweep = [&](entt::entity entity, Target target, const Component::Transform &transform) {
+                if (const auto result = Collision::sweep(ballTransform, displacement, transform); result && result->time < hit.contact.time) {
+                    hit = Hit{target, entity, 0, *result};
+                }
+            };
+
+            goalView.each([&](entt::entity entity, const Component::Transform &goalTransform) { sweep(entity, Target::Goal, goalTransform); });
+            wallView.each([&](entt::entity entity, const Component::Transform &wallTransform) { sweep(entity, Target::Wall, wallTransform); });
+            paddleView.each([&](entt::entity entity, const Component::Transform &paddleTransform) { sweep(entity, Target::Paddle, paddleTransform); });
+
+            const glm::vec2 sweptMin = glm::min(ballTransform.position, ballTransform.position + displacement);
+            const glm::vec2 sweptMax = glm::max(ballTransform.position, ballTransform.position + displacement) + ballTransform.scale;
+            mBrickBoxes.clear();
+            if (mConfig.denseBricks) {
+                mBrickCells.clear();
+                const BrickField::CellRange range = mBrickField.getCellRange(sweptMin, sweptMax);
+                for (std::int32_t row = range.minRow; row <= range.maxRow; ++row) {
+                    for (std::int32_t column = range.minColumn; column <= range.maxColumn; ++column) {
+                        const std::uint32_t cell = static_cast<std::uint32_t>(row) * mBrickField.getColumns() + static_cast<std::uint32_t>(column);
+                        if (mBrickField.isAlive(cell)) {
+                            mBrickBoxes.add(mBrickField.getTransform(cell));
+                            mBrickCells.push_back(cell);
+                        }
+                    }
+                }
+                if (const auto result = Collision::sweep(ballTransform, displacement, mBrickBoxes); result && result->contact.time < hit.contact.time) {
+                    hit = Hit{Target::BrickCell, entt::null, mBrickCells[result->index], result->contact};
+                }
+            } else {
+                const std::vector<entt::entity> &bricks = mBrickGrid.query(sweptMin, sweptMax);
+                for (const entt::entity entity: bricks) {
+                    mBrickBoxes.add(mRegistry.get<Component::Transform>(entity));
+                }
+                if (const auto result = Collision::sweep(ballTransform, displacement, mBrickBoxes); result && result->contact.time < hit.contact.time) {
+                    hit = Hit{Target::Brick, bricks[result->index], 0, result->contact};
+                }
+            }
+
+            if (hit.target == Target::None) {
+                ballTransform.position += displacement;
+                break;
+            }
+
+            ballTransform.position += displacement * hit.contact.time;
+            if (hit.contact.normal.x != 0.0f) {
+                ballMovement.velocity.x = hit.contact.normal.x * glm::abs(ballMovement.velocity.x);
+            }
+            if (hit.contact.normal.y != 0.0f) {
+                ballMovement.velocity.y = hit.contact.normal.y * glm::abs(ballMovement.velocity.y);
+            }
+            remaining *= 1.0f - hit.contact.time;
+
+            bool lost = false;
+            switch (hit.target) {
+                case Target::Goal:
+                    rumble(100);
+                    mDispatcher.trigger(Event::BallLost{ball});
+                    lost = mConfig.multiBall;
+                    break;
+                case Target::Brick:
+                    rumble(200);
+                    hitBrick(hit.entity);
+                    break;
+                case Target::BrickCell:
+                    rumble(200);
+                    hitBrickCell(hit.cell);
+                    break;
+                default:
+                    rumble(100);
+                    break;
+            }
+            if (lost) {
+                break;
+            }
+        }
+    });
+
+    // Lost balls leave once the view is no longer being iterated.
+    if (!mLostBalls.empty()) {
+        mRegistry.destroy(mLostBalls.begin(), mLostBalls.end());
+        mLostBalls.clear();
+    }
+}
+
+void Simulation::resolveBallCollisions() {
+    const Profiler::Scope scope(mProfiler, "resolveBallCollisions");
+
+    // Sort and sweep along x. Balls move a few pixels per step, so the list
+    // from the last step is nearly sorted and insertion sort runs in close to
+    // linear time; after balls come or go it is rebuilt and fully sorted.
+    const bool rebuilt = mBallsChanged;
+    if (mBallsChanged) {
+        mSweptBalls.clear();
+        mRegistry.view<Component::Ball>().each([this](entt::entity entity) {
+            mSweptBalls.push_back(SweptBall{glm::vec2(0.0f, 0.0f), glm::vec2(0.0f, 0.0f), glm::vec2(0.0f, 0.0f), entity, nullptr});
+        });
+        mBallsChanged = false;
+    }
+    for (SweptBall &ball: mSweptBalls) {
+        const auto [transform, movement] = mRegistry.get<Component::Transform, Component::Movement>(ball.entity);
+        ball.min = transform.position;
+        ball.max = transform.position + transform.scale;
+        ball.velocity = movement.velocity;
+        ball.movement = &movement;
+    }
+    const auto before = [](const SweptBall &ball, const SweptBall &other) {
+        return sweepsBefore(ball.min.x, ball.entity, other.min.x, other.entity);
+    };
+    if (rebuilt) {
+        std::sort(mSweptBalls.begin(), mSweptBalls.end(), before);
+    } else {
+        for (std::size_t index = 1; index < mSweptBalls.size(); ++index) {
+            const SweptBall ball = mSweptBalls[index];
+            std::size_t slot = index;
+            for (; slot > 0 && before(ball, mSweptBalls[slot - 1]); --slot) {
+                mSweptBalls[slot] = mSweptBalls[slot - 1];
+            }
+            mSweptBalls[slot] = ball;
+        }
+    }
+
+    for (std::size_t index = 0; index < mSweptBalls.size(); ++index) {
+        SweptBall &ball = mSweptBalls[index];
+        const glm::vec2 min = ball.min;
+        const glm::vec2 max = ball.max;
+        for (std::size_t next = index + 1; next < mSweptBalls.size() && mSweptBalls[next].min.x < max.x; ++next) {
+            SweptBall &other = mSweptBalls[next];
+            if (other.min.y < max.y && min.y < other.max.y) {
+                bounceBalls(min, max, ball.velocity, other.min, other.max, other.velocity);
+            }
+        }
+    }
+    for (const SweptBall &ball: mSweptBalls) {
+        ball.movement->velocity = ball.velocity;
+    }
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "BrickField.hpp"
+#include "Collision.hpp"
+#include "Component.hpp"
+#include "Event.hpp"
+#include "Level.hpp"
+#include "Profiler.hpp"
+#include "Prototype.hpp"
+#include "RegistryState.hpp"
+#include "SpatialGrid.hpp"
+
+#include <entt/entt.hpp>
+
+#include <cstdint>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+class Simulation {
+public:
+    struct Input {
+        bool left = false;
+        bool right = false;
+    };
+
+    // Balls and physics; the built-in level is generated from the brick fields
+    // unless a Level::File is given.
+    struct Config {
+        std::uint32_t balls = 1;
+        std::uint32_t brickRows = 8;
+        std::uint32_t brickColumns = 10;
+        glm::vec2 brickSize = glm::vec2(80.0f, 20.0f);
+        glm::vec2 ballVelocity = glm::vec2(200.0f, 200.0f);
+        // Keeps bricks in a BrickField instead of one entity per brick.
+        bool denseBricks = false;
+        // Balls start spread out and bounce off each other, and a lost ball
+        // leaves the game instead of ending it until the last one is gone.
+        bool multiBall = false;
+    };
+
+    // Memory held by the registry storage of one component type.
+    struct StorageUsage {
+        std::string_view name;
+        std::size_t size = 0;
+        // Components the storage has room for before it grows.
+        std::size_t capacity = 0;
+        // Packed entities and components plus the sparse index, approximately.
+        std::size_t bytes = 0;
+    };
+
+    Simulation() : Simulation(Config{}) {}
+    // The level must outlive the simulation; null plays the built-in level.
+    explicit Simulation(const Config &config, const Level::File *level = nullptr);
+
+    // Registry and dispatcher listeners point back at this instance.
+    Simulation(const Simulation &) = delete;
+    Simulation &operator=(const Simulation &) = delete;
+
+    void reset();
+
+    void fixedUpdate(float fixedDeltaTime, const Input &input);
+    void update();
+
+    // The systems run by fixedUpdate(), in order. Public so they can be measured in isolation.
+    void updatePositions(float fixedDeltaTime, const Input &input);
+    void checkCollisions(float fixedDeltaTime);
+    // Multi-ball mode only.
+    void resolveBallCollisions();
+
+    // Set by Event::BallLost or Event::LevelCleared, cleared when update() starts a new game.
+    [[nodiscard]] bool isGameOver() const { return mGameOver; }
+    [[nodiscard]] bool isCleared() const { return mBrickCount == 0 && mBrickField.empty(); }
+
+    // Live entity counts, kept up to date by registry signals.
+    [[nodiscard]] std::uint32_t getBrickCount() const { return mBrickCount; }
+    [[nodiscard]] std::uint32_t getBallCount() const { return mBallCount; }
+
+    [[nodiscard]] std::uint64_t getSteps() const { return mSteps; }
+    [[nodiscard]] std::uint32_t getBricksDestroyed() const { return mBricksDestroyed; }
+    [[nodiscard]] std::uint32_t getBallsLost() const { return mBallsLost; }
+
+    // One entry per component type the simulation creates, in ForComponents order.
+    [[nodiscard]] std::vector<StorageUsage> getStorageUsage() const;
+
+    // FNV-1a hash of the gameplay state, used to verify that replays stay deterministic.
+    [[nodiscard]] std::uint64_t getStateHash() const;
+
+    // Compact binary copy of the whole gameplay state, cheap enough to take
+    // every step. Loads only into a simulation with the same config and level
+    // that has been reset() at least once; stepping a loaded state continues
+    // exactly like the saved simulation would have.
+    void saveState(std::vector<std::uint8_t> &bytes) const;
+    bool loadState(const std::uint8_t *data, std::size_t size);
+
+    // Longest rumble requested by collisions since the last call, in milliseconds.
+    std::uint32_t consumeRumble();
+
+    // Times the systems of every step when set; may be null.
+    void setProfiler(Profiler *profiler) { mProfiler = profiler; }
+
+    // Synchronous notifications about bricks, see Event.hpp.
+    [[nodiscard]] entt::dispatcher &getDispatcher() { return mDispatcher; }
+
+    // The level being played, the built-in one unless given to the constructor.
+    [[nodiscard]] const Level::File &getLevel() const { return *mLevel; }
+
+    // Bricks of dense levels; empty unless Config::denseBricks is set.
+    [[nodiscard]] const BrickField &getBrickField() const { return mBrickField; }
+
+    [[nodiscard]] entt::registry &getRegistry() { return mRegistry; }
+    [[nodiscard]] const entt::registry &getRegistry() const { return mRegistry; }
+
+private:
+    // Every component the simulation creates, as kept by prototypes and saved states.
+    template<template<typename...> typename Storage>
+    using ForComponents = Storage<Component::Ball, Component::Brick, Component::Goal, Component::Health, Component::Movement, Component::Paddle, Component::Sprite, Component::Transform, Component::Wall>;
+
+    // Starts a game: builds the level the first time and restores it from mPrototype after that.
+    void respawn();
+    void respawnGoal();
+    void respawnWalls();
+    void respawnBricks();
+    void respawnBalls();
+    void respawnPaddles();
+
+    // A ball in the sort-and-sweep list. Bounds and velocity are copied in
+    // every step so the sweep only touches this contiguous array; velocities
+    // are written back through movement at the end.
+    struct SweptBall {
+        glm::vec2 min;
+        glm::vec2 max;
+        glm::vec2 velocity;
+        entt::entity entity;
+        Component::Movement *movement;
+    };
+
+    void hitBrick(entt::entity entity);
+    void hitBrickCell(std::uint32_t cell);
+
+    void onBrickConstruct(entt::registry &registry, entt::entity entity);
+    void onBrickDestroy(entt::registry &registry, entt::entity entity);
+    void onBallConstruct(entt::registry &registry, entt::entity entity);
+    void onBallDestroy(entt::registry &registry, entt::entity entity);
+
+    void onBallLost(const Event::BallLost &event);
+    void onLevelCleared(const Event::LevelCleared &event);
+    void rumble(std::uint32_t duration_ms);
+
+    Config mConfig;
+    Level::File mDefaultLevel;
+    const Level::File *mLevel = nullptr;
+    Profiler *mProfiler = nullptr;
+    bool mGameOver = false;
+    std::uint64_t mSteps = 0;
+    std::uint32_t mBricksDestroyed = 0;
+    std::uint32_t mBallsLost = 0;
+    std::uint32_t mBrickCount = 0;
+    std::uint32_t mBallCount = 0;
+    std::uint32_t mRumbleDuration = 0;
+    entt::registry mRegistry;
+    entt::dispatcher mDispatcher;
+    SpatialGrid mBrickGrid;
+    // The registry and brick grid right after the level was first built.
+    ForComponents<Prototype> mPrototype;
+    SpatialGrid mPrototypeGrid;
+    ForComponents<RegistryState> mRegistryState;
+    BrickField mBrickField;
+    // Candidate bricks of the current sweep (and their cells in dense mode), reused across steps.
+    Collision::Boxes mBrickBoxes;
+    std::vector<std::uint32_t> mBrickCells;
+    // Balls sorted by left edge, kept from step to step and rebuilt when balls
+    // are created or destroyed.
+    std::vector<SweptBall> mSweptBalls;
+    bool mBallsChanged = true;
+    // Balls lost during the current step in multi-ball mode, destroyed after it.
+    std::vector<entt::entity> mLostBalls;
+};
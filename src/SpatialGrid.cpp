@@ -0,0 +1,86 @@
+#include "SpatialGrid.hpp"
+
+#include <algorithm>
+
+void SpatialGrid::reset(glm::vec2 origin, glm::vec2 size, glm::vec2 cellSize) {
+    mOrigin = origin;
+    mCellSize = cellSize;
+    mColumns = std::max(static_cast<std::int32_t>(glm::ceil(size.x / cellSize.x)), 1);
+    mRows = std::max(static_cast<std::int32_t>(glm::ceil(size.y / cellSize.y)), 1);
+    mCells.resize(static_cast<std::size_t>(mColumns) * static_cast<std::size_t>(mRows));
+    clear();
+}
+
+void SpatialGrid::clear() {
+    for (std::vector<entt::entity> &cell: mCells) {
+        cell.clear();
+    }
+}
+
+void SpatialGrid::insert(entt::entity entity, glm::vec2 min, glm::vec2 max) {
+    const CellRange range = getCellRange(min, max);
+    for (std::int32_t y = range.minY; y <= range.maxY; ++y) {
+        for (std::int32_t x = range.minX; x <= range.maxX; ++x) {
+            mCells[static_cast<std::size_t>(y * mColumns + x)].push_back(entity);
+        }
+    }
+}
+
+void SpatialGrid::remove(entt::entity entity, glm::vec2 min, glm::vec2 max) {
+    const CellRange range = getCellRange(min, max);
+    for (std::int32_t y = range.minY; y <= range.maxY; ++y) {
+        for (std::int32_t x = range.minX; x <= range.maxX; ++x) {
+            std::vector<entt::entity> &cell = mCells[static_cast<std::size_t>(y * mColumns + x)];
+            if (const auto it = std::find(cell.begin(), cell.end(), entity); it != cell.end()) {
+                *it = cell.back();
+                cell.pop_back();
+            }
+        }
+    }
+}
+
+const std::vector<entt::entity> &SpatialGrid::query(glm::vec2 min, glm::vec2 max) {
+    mResult.clear();
+    const CellRange range = getCellRange(min, max);
+    for (std::int32_t y = range.minY; y <= range.maxY; ++y) {
+        for (std::int32_t x = range.minX; x <= range.maxX; ++x) {
+            const std::vector<entt::entity> &cell = mCells[static_cast<std::size_t>(y * mColumns + x)];
+            mResult.insert(mResult.end(), cell.begin(), cell.end());
+        }
+    }
+    if (range.minX != range.maxX || range.minY != range.maxY) {
+        std::sort(mResult.begin(), mResult.end());
+        mResult.erase(std::unique(mResult.begin(), mResult.end()), mResult.end());
+    }
+    return mResult;
+}
+
+void SpatialGrid::save(std::vector<std::uint8_t> &bytes) const {
+    for (const std::vector<entt::entity> &cell: mCells) {
+        Serialize::write(bytes, static_cast<std::uint32_t>(cell.size()));
+        Serialize::writeArray(bytes, cell.data(), cell.size());
+    }
+}
+
+bool SpatialGrid::load(Serialize::Reader &reader) {
+    for (std::vector<entt::entity> &cell: mCells) {
+        std::uint32_t size = 0;
+        if (!reader.read(size)) {
+            return false;
+        }
+        cell.resize(size);
+        if (!reader.readArray(cell.data(), size)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+SpatialGrid::CellRange SpatialGrid::getCellRange(glm::vec2 min, glm::vec2 max) const {
+    // The last cell is found from the exclusive upper bound, so a box ending
+    // exactly on a cell boundary does not spill into the next cell.
+    const glm::vec2 limit(static_cast<float>(mColumns - 1), static_cast<float>(mRows - 1));
+    const glm::vec2 first = glm::clamp(glm::floor((min - mOrigin) / mCellSize), glm::vec2(0.0f, 0.0f), limit);
+    const glm::vec2 last = glm::clamp(glm::ceil((max - mOrigin) / mCellSize) - glm::vec2(1.0f, 1.0f), glm::vec2(0.0f, 0.0f), limit);
+    return CellRange{static_cast<std::int32_t>(first.x), static_cast<std::int32_t>(first.y), static_cast<std::int32_t>(last.x), static_cast<std::int32_t>(last.y)};
+}
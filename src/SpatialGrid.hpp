@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Serialize.hpp"
+
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// Uniform grid over a rectangular area. Entities are stored in every cell their
+// box overlaps; boxes outside the area are clamped to the border cells.
+class SpatialGrid {
+public:
+    void reset(glm::vec2 origin, glm::vec2 size, glm::vec2 cellSize);
+    void clear();
+
+    void insert(entt::entity entity, glm::vec2 min, glm::vec2 max);
+    void remove(entt::entity entity, glm::vec2 min, glm::vec2 max);
+
+    // Entities whose cells overlap the box, each listed once. The returned
+    // vector is reused by the next query.
+    const std::vector<entt::entity> &query(glm::vec2 min, glm::vec2 max);
+
+    // Contents of every cell in order, so a loaded grid answers queries in
+    // the same order as the saved one. Loading needs a grid of the same size.
+    void save(std::vector<std::uint8_t> &bytes) const;
+    bool load(Serialize::Reader &reader);
+
+    [[nodiscard]] std::size_t getCellCount() const { return mCells.size(); }
+
+private:
+    struct CellRange {
+        std::int32_t minX;
+        std::int32_t minY;
+        std::int32_t maxX;
+        std::int32_t maxY;
+    };
+
+    [[nodiscard]] CellRange getCellRange(glm::vec2 min, glm::vec2 max) const;
+
+    glm::vec2 mOrigin = glm::vec2(0.0f, 0.0f);
+    glm::vec2 mCellSize = glm::vec2(1.0f, 1.0f);
+    std::int32_t mColumns = 0;
+    std::int32_t mRows = 0;
+    std::vector<std::vector<entt::entity>> mCells;
+    std::vector<entt::entity> mResult;
+};
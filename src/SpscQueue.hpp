@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer
+// thread. Each side caches the other side's index and only reloads it when
+// the queue looks full or empty, so the common case touches no shared cache line.
+template<typename T, std::size_t Capacity>
+class SpscQueue {
+    static_assert(std::has_single_bit(Capacity), "Capacity must be a power of two");
+
+public:
+    // Producer side; returns false and drops the value when the queue is full.
+    bool push(const T &value) {
+        const std::size_t tail = mTail.load(std::memory_order_relaxed);
+        if (tail - mHeadCache == Capacity) {
+            mHeadCache = mHead.load(std::memory_order_acquire);
+            if (tail - mHeadCache == Capacity) {
+                return false;
+            }
+        }
+        mItems[tail & (Capacity - 1)] = value;
+        mTail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; copies the oldest value without removing it, or returns
+    // false when the queue is empty.
+    bool peek(T &value) {
+        const std::size_t head = mHead.load(std::memory_order_relaxed);
+        if (head == mTailCache) {
+            mTailCache = mTail.load(std::memory_order_acquire);
+            if (head == mTailCache) {
+                return false;
+            }
+        }
+        value = mItems[head & (Capacity - 1)];
+        return true;
+    }
+
+    // Consumer side; returns false when the queue is empty.
+    bool pop(T &value) {
+        const std::size_t head = mHead.load(std::memory_order_relaxed);
+        if (head == mTailCache) {
+            mTailCache = mTail.load(std::memory_order_acquire);
+            if (head == mTailCache) {
+                return false;
+            }
+        }
+        value = mItems[head & (Capacity - 1)];
+        mHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::array<T, Capacity> mItems{};
+    alignas(64) std::atomic<std::size_t> mTail = 0;
+    std::size_t mHeadCache = 0;
+    alignas(64) std::atomic<std::size_t> mHead = 0;
+    std::size_t mTailCache = 0;
+};
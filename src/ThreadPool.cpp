@@ -0,0 +1,124 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+namespace {
+    thread_local std::size_t workerIndex = static_cast<std::size_t>(-1);
+}// namespace
+
+ThreadPool::ThreadPool(std::size_t threadCount) {
+    threadCount = std::max<std::size_t>(threadCount, 1);
+    for (std::size_t index = 0; index < threadCount; ++index) {
+        mQueues.push_back(std::make_unique<Queue>());
+    }
+    for (std::size_t index = 0; index < threadCount; ++index) {
+        mThreads.emplace_back(&ThreadPool::workerLoop, this, index);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mMutex);
+        mStopping = true;
+    }
+    mWorkAvailable.notify_all();
+    for (std::thread &thread: mThreads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    // Tasks spawned by a worker stay on its own deque; others are spread round-robin.
+    std::size_t index = workerIndex;
+    if (index >= mQueues.size()) {
+        index = mNextQueue.fetch_add(1, std::memory_order_relaxed) % mQueues.size();
+    }
+
+    mPending.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard lock(mQueues[index]->mutex);
+        mQueues[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard lock(mMutex);
+        mQueued.fetch_add(1, std::memory_order_release);
+    }
+    mWorkAvailable.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::function<void()> task;
+    while (mPending.load(std::memory_order_acquire) > 0) {
+        if (stealTask(mQueues.size(), task)) {
+            runTask(task);
+            continue;
+        }
+        std::unique_lock lock(mMutex);
+        mWorkFinished.wait(lock, [this] { return mPending.load(std::memory_order_acquire) == 0 || mQueued.load(std::memory_order_acquire) > 0; });
+    }
+}
+
+void ThreadPool::parallelFor(std::size_t count, std::size_t grainSize, const std::function<void(std::size_t begin, std::size_t end)> &function) {
+    grainSize = std::max<std::size_t>(grainSize, 1);
+    for (std::size_t begin = 0; begin < count; begin += grainSize) {
+        const std::size_t end = std::min(begin + grainSize, count);
+        submit([&function, begin, end] { function(begin, end); });
+    }
+    wait();
+}
+
+bool ThreadPool::popTask(std::size_t index, std::function<void()> &task) {
+    Queue &queue = *mQueues[index];
+    std::lock_guard lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    mQueued.fetch_sub(1, std::memory_order_acq_rel);
+    return true;
+}
+
+bool ThreadPool::stealTask(std::size_t index, std::function<void()> &task) {
+    for (std::size_t offset = 1; offset <= mQueues.size(); ++offset) {
+        const std::size_t victim = (index + offset) % mQueues.size();
+        if (victim == index) {
+            continue;
+        }
+        Queue &queue = *mQueues[victim];
+        std::lock_guard lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            continue;
+        }
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        mQueued.fetch_sub(1, std::memory_order_acq_rel);
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::runTask(std::function<void()> &task) {
+    task();
+    task = nullptr;
+    if (mPending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard lock(mMutex);
+        mWorkFinished.notify_all();
+    }
+}
+
+void ThreadPool::workerLoop(std::size_t index) {
+    workerIndex = index;
+    std::function<void()> task;
+    while (true) {
+        if (popTask(index, task) || stealTask(index, task)) {
+            runTask(task);
+            continue;
+        }
+        std::unique_lock lock(mMutex);
+        mWorkAvailable.wait(lock, [this] { return mStopping || mQueued.load(std::memory_order_acquire) > 0; });
+        if (mStopping && mQueued.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
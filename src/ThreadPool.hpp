@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing thread pool. Every worker owns a deque: it pops its own tasks
+// from the back and steals from the front of the other deques when idle.
+class ThreadPool {
+public:
+    explicit ThreadPool(std::size_t threadCount = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    void submit(std::function<void()> task);
+
+    // Blocks until every submitted task has finished, running tasks on the
+    // calling thread meanwhile. Must not be called from inside a task.
+    void wait();
+
+    // Splits [0, count) into chunks of at most grainSize and waits for all of them.
+    void parallelFor(std::size_t count, std::size_t grainSize, const std::function<void(std::size_t begin, std::size_t end)> &function);
+
+    [[nodiscard]] std::size_t getThreadCount() const { return mThreads.size(); }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    bool popTask(std::size_t index, std::function<void()> &task);
+    bool stealTask(std::size_t index, std::function<void()> &task);
+    void runTask(std::function<void()> &task);
+    void workerLoop(std::size_t index);
+
+    std::vector<std::unique_ptr<Queue>> mQueues;
+    std::vector<std::thread> mThreads;
+    std::mutex mMutex;
+    std::condition_variable mWorkAvailable;
+    std::condition_variable mWorkFinished;
+    std::atomic<std::size_t> mQueued = 0;
+    std::atomic<std::size_t> mPending = 0;
+    std::atomic<std::size_t> mNextQueue = 0;
+    bool mStopping = false;
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Lock-free triple buffer handing the latest value from one writer thread to
+// one reader thread. The writer fills its back buffer and publishes it; the
+// reader picks up whatever was published last. Neither side ever waits, and
+// values the reader did not get to in time are overwritten, not queued.
+// Buffers are recycled, so a writer that only updates part of a value must
+// bring the rest of its back buffer up to date itself.
+template<typename T>
+class TripleBuffer {
+public:
+    // Writer side: the buffer to fill before the next publish().
+    [[nodiscard]] T &getWriteBuffer() { return mBuffers[mWrite]; }
+
+    void publish() {
+        const std::uint8_t previous = mShared.exchange(static_cast<std::uint8_t>(mWrite | freshBit), std::memory_order_acq_rel);
+        mWrite = previous & indexMask;
+    }
+
+    // Reader side: switches to the most recently published buffer and returns
+    // true when there was one the reader had not seen yet.
+    bool update() {
+        if ((mShared.load(std::memory_order_relaxed) & freshBit) == 0) {
+            return false;
+        }
+        const std::uint8_t previous = mShared.exchange(mRead, std::memory_order_acq_rel);
+        mRead = previous & indexMask;
+        return true;
+    }
+
+    [[nodiscard]] const T &getReadBuffer() const { return mBuffers[mRead]; }
+
+private:
+    static constexpr std::uint8_t indexMask = 0x3u;
+    static constexpr std::uint8_t freshBit = 0x4u;
+
+    std::array<T, 3> mBuffers{};
+    // Index of the buffer between the two threads, plus freshBit while it
+    // holds a value the reader has not taken yet.
+    alignas(64) std::atomic<std::uint8_t> mShared = 1;
+    alignas(64) std::uint8_t mWrite = 0;
+    alignas(64) std::uint8_t mRead = 2;
+};
@@ -0,0 +1,139 @@
+#include "VectorEnv.hpp"
+
+#include "Scene.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Floats per game before the balls: paddle center x, y.
+    constexpr std::size_t paddleFloats = 2;
+    // Center x, y, velocity x, y and the in-play flag.
+    constexpr std::size_t ballFloats = 5;
+    // Chunks per thread, so threads that finish early steal the rest.
+    constexpr std::size_t chunksPerThread = 4;
+}// namespace
+
+VectorEnv::VectorEnv(const Config &config, const Level::File *level) : mConfig(config), mFixedDeltaTime(1.0f / config.tickRate) {
+    mConfig.ticksPerStep = std::max<std::uint32_t>(mConfig.ticksPerStep, 1);
+    mGames.reserve(mConfig.envCount);
+    for (std::size_t index = 0; index < mConfig.envCount; ++index) {
+        mGames.push_back(std::make_unique<Game>(mConfig.simulation, level));
+    }
+
+    const Level::Header header = mGames.empty() ? Level::Header{} : mGames.front()->simulation.getLevel().getHeader();
+    mColumns = header.columns;
+    mRows = header.rows;
+    mOrigin = glm::vec2(header.origin[0], header.origin[1]);
+    mCellSize = glm::vec2(header.cellSize[0], header.cellSize[1]);
+    mObservationSize = paddleFloats + ballFloats * mConfig.simulation.balls + static_cast<std::size_t>(mColumns) * mRows;
+
+    // The calling thread runs chunks too while it waits for the pool.
+    const std::size_t threads = std::min(std::max<std::size_t>(mConfig.threads, 1), std::max<std::size_t>(mGames.size(), 1));
+    if (threads > 1) {
+        mThreadPool = std::make_unique<ThreadPool>(threads - 1);
+        mGrainSize = std::max<std::size_t>((mGames.size() + threads * chunksPerThread - 1) / (threads * chunksPerThread), 1);
+    }
+}
+
+void VectorEnv::setBuffers(float *observations, float *rewards, std::uint8_t *dones) {
+    mObservations = observations;
+    mRewards = rewards;
+    mDones = dones;
+}
+
+void VectorEnv::reset() {
+    forEachGame([this](std::size_t index) {
+        resetGame(index);
+        observe(index);
+    });
+}
+
+void VectorEnv::step(const std::uint8_t *actions) {
+    forEachGame([this, actions](std::size_t index) {
+        stepGame(index, actions[index]);
+        observe(index);
+    });
+}
+
+void VectorEnv::render(std::uint8_t *frames, int width, int height, Rasterizer::Format format) {
+    const std::ptrdiff_t pitch = static_cast<std::ptrdiff_t>(static_cast<std::size_t>(width) * Rasterizer::getBytesPerPixel(format));
+    const std::size_t frameSize = static_cast<std::size_t>(pitch) * static_cast<std::size_t>(height);
+    forEachGame([&](std::size_t index) {
+        Rasterizer rasterizer;
+        rasterizer.setTarget(frames + index * frameSize, width, height, pitch, format);
+        Scene::rasterize(mGames[index]->simulation, rasterizer);
+    });
+}
+
+void VectorEnv::resetGame(std::size_t index) {
+    Game &game = *mGames[index];
+    game.simulation.reset();
+    game.steps = 0;
+    game.bricksDestroyed = 0;
+    game.ballsLost = 0;
+}
+
+void VectorEnv::stepGame(std::size_t index, std::uint8_t action) {
+    Game &game = *mGames[index];
+    Simulation &simulation = game.simulation;
+    const Simulation::Input input{action == Left, action == Right};
+    for (std::uint32_t tick = 0; tick < mConfig.ticksPerStep && !simulation.isGameOver(); ++tick) {
+        simulation.fixedUpdate(mFixedDeltaTime, input);
+    }
+    ++game.steps;
+
+    mRewards[index] = static_cast<float>(simulation.getBricksDestroyed() - game.bricksDestroyed) - static_cast<float>(simulation.getBallsLost() - game.ballsLost);
+    game.bricksDestroyed = simulation.getBricksDestroyed();
+    game.ballsLost = simulation.getBallsLost();
+
+    const bool done = simulation.isGameOver() || (mConfig.maxSteps > 0 && game.steps >= mConfig.maxSteps);
+    mDones[index] = done;
+    if (done) {
+        resetGame(index);
+    }
+}
+
+void VectorEnv::observe(std::size_t index) {
+    const entt::registry &registry = mGames[index]->simulation.getRegistry();
+    const BrickField &brickField = mGames[index]->simulation.getBrickField();
+    float *observation = mObservations + index * mObservationSize;
+
+    registry.view<const Component::Paddle, const Component::Transform>().each([&](entt::entity, const Component::Transform &transform) {
+        observation[0] = transform.position.x + 0.5f * transform.scale.x;
+        observation[1] = transform.position.y + 0.5f * transform.scale.y;
+    });
+
+    float *balls = observation + paddleFloats;
+    float *ballsEnd = balls + ballFloats * mConfig.simulation.balls;
+    float *ball = balls;
+    registry.view<const Component::Ball, const Component::Transform, const Component::Movement>().each([&](entt::entity, const Component::Transform &transform, const Component::Movement &movement) {
+        if (ball == ballsEnd) {
+            return;
+        }
+        ball[0] = transform.position.x + 0.5f * transform.scale.x;
+        ball[1] = transform.position.y + 0.5f * transform.scale.y;
+        ball[2] = movement.velocity.x;
+        ball[3] = movement.velocity.y;
+        ball[4] = 1.0f;
+        ball += ballFloats;
+    });
+    std::fill(ball, ballsEnd, 0.0f);
+
+    float *cells = ballsEnd;
+    const std::size_t cellCount = static_cast<std::size_t>(mColumns) * mRows;
+    if (brickField.getCellCount() > 0) {
+        for (std::uint32_t cell = 0; cell < cellCount; ++cell) {
+            cells[cell] = static_cast<float>(brickField.getHitPoints(cell));
+        }
+        return;
+    }
+
+    // Brick entities sit exactly on their level cell, so the cell follows from the position.
+    std::fill(cells, cells + cellCount, 0.0f);
+    registry.view<const Component::Brick, const Component::Transform>().each([&](entt::entity entity, const Component::Transform &transform) {
+        const glm::vec2 cell = glm::round((transform.position - mOrigin) / mCellSize);
+        const Component::Health *health = registry.try_get<Component::Health>(entity);
+        cells[static_cast<std::size_t>(cell.y) * mColumns + static_cast<std::size_t>(cell.x)] = health ? static_cast<float>(health->hitPoints) : 1.0f;
+    });
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Level.hpp"
+#include "Rasterizer.hpp"
+#include "Simulation.hpp"
+#include "ThreadPool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// A batch of independent headless games stepped together, each with its own
+// action, writing observations, rewards and done flags into buffers owned by
+// the caller. Backs the C API in BreakoutEnv.h.
+class VectorEnv {
+public:
+    enum Action : std::uint8_t { Stay, Left, Right };
+
+    struct Config {
+        std::size_t envCount = 16;
+        // Threads stepping games, the calling thread included.
+        std::size_t threads = std::thread::hardware_concurrency();
+        std::uint32_t ticksPerStep = 1;
+        float tickRate = 240.0f;
+        // Steps after which a game is cut short; 0 never.
+        std::uint64_t maxSteps = 0;
+        Simulation::Config simulation;
+    };
+
+    // The level must outlive the environments; null plays the built-in level.
+    explicit VectorEnv(const Config &config, const Level::File *level = nullptr);
+
+    [[nodiscard]] std::size_t getEnvCount() const { return mGames.size(); }
+    [[nodiscard]] std::size_t getThreadCount() const { return mThreadPool ? mThreadPool->getThreadCount() + 1 : 1; }
+    // Floats per game, see breakout_env_observation_size().
+    [[nodiscard]] std::size_t getObservationSize() const { return mObservationSize; }
+    [[nodiscard]] std::uint32_t getBrickColumns() const { return mColumns; }
+    [[nodiscard]] std::uint32_t getBrickRows() const { return mRows; }
+
+    void setBuffers(float *observations, float *rewards, std::uint8_t *dones);
+    [[nodiscard]] bool hasBuffers() const { return mObservations && mRewards && mDones; }
+
+    // Both write every game's observation; step() also its reward and done flag.
+    void reset();
+    void step(const std::uint8_t *actions);
+    // Draws every game into consecutive width x height frames of the given format.
+    void render(std::uint8_t *frames, int width, int height, Rasterizer::Format format);
+
+private:
+    struct Game {
+        Game(const Simulation::Config &config, const Level::File *level) : simulation(config, level) {}
+
+        Simulation simulation;
+        std::uint64_t steps = 0;
+        std::uint32_t bricksDestroyed = 0;
+        std::uint32_t ballsLost = 0;
+    };
+
+    void resetGame(std::size_t index);
+    void stepGame(std::size_t index, std::uint8_t action);
+    void observe(std::size_t index);
+
+    // Runs function(index) for every game, split across the pool when there is one.
+    template<typename Function>
+    void forEachGame(Function &&function) {
+        if (!mThreadPool) {
+            for (std::size_t index = 0; index < mGames.size(); ++index) {
+                function(index);
+            }
+            return;
+        }
+        mThreadPool->parallelFor(mGames.size(), mGrainSize, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t index = begin; index < end; ++index) {
+                function(index);
+            }
+        });
+    }
+
+    Config mConfig;
+    float mFixedDeltaTime;
+    std::uint32_t mColumns = 0;
+    std::uint32_t mRows = 0;
+    glm::vec2 mOrigin = glm::vec2(0.0f, 0.0f);
+    glm::vec2 mCellSize = glm::vec2(1.0f, 1.0f);
+    std::size_t mObservationSize = 0;
+    std::vector<std::unique_ptr<Game>> mGames;
+    std::unique_ptr<ThreadPool> mThreadPool;
+    std::size_t mGrainSize = 1;
+    float *mObservations = nullptr;
+    float *mRewards = nullptr;
+    std::uint8_t *mDones = nullptr;
+};